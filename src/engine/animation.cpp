@@ -0,0 +1,322 @@
+#include "animation.hpp"
+#include "entity/component/matrixAnimation.hpp"
+#include "entity/pawns/spatialPawn.hpp"
+
+/*
+ * AnimationClip
+ */
+
+AnimationClip::AnimationClip(float duration, bool additive) {
+	this->duration = duration > 0 ? duration : 1;
+	this->additive = additive;
+}
+
+void AnimationClip::addKey(Channel channel, float time, glm::vec4 value) {
+	Track& track = tracks[channel];
+	const auto it = std::ranges::upper_bound(track.times, time);
+	const size_t index = it - track.times.begin();
+
+	track.times.insert(it, time);
+	track.values.insert(track.values.begin() + index, value);
+}
+
+void AnimationClip::addPositionKey(float time, glm::vec3 position) {
+	addKey(POSITION, time, glm::vec4(position, 0));
+}
+
+void AnimationClip::addRotationKey(float time, glm::quat rotation) {
+	addKey(ROTATION, time, glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w));
+}
+
+void AnimationClip::addScaleKey(float time, glm::vec3 scale) {
+	addKey(SCALE, time, glm::vec4(scale, 0));
+}
+
+const AnimationClip::Track& AnimationClip::getTrack(Channel channel) const {
+	return tracks[channel];
+}
+
+float AnimationClip::getDuration() const {
+	return duration;
+}
+
+bool AnimationClip::isAdditive() const {
+	return additive;
+}
+
+std::shared_ptr<const AnimationClip> AnimationClip::rotation() {
+	static std::shared_ptr<const AnimationClip> clip = [] () {
+		auto clip = std::make_shared<AnimationClip>(1.0f);
+
+		// an eighth of a turn between keys keeps the normalized lerp close to a constant speed
+		for (int i = 0; i <= 8; i ++) {
+			clip->addRotationKey(i / 8.0f, glm::rotate(glm::identity<glm::quat>(), (float) (i * M_PI / 4), glm::vec3(1, 1, 1)));
+		}
+
+		return clip;
+	}();
+
+	return clip;
+}
+
+std::shared_ptr<const AnimationClip> AnimationClip::translation() {
+	static std::shared_ptr<const AnimationClip> clip = [] () {
+		auto clip = std::make_shared<AnimationClip>(1.0f, true);
+		clip->addPositionKey(0.0f, {0, 0, 0});
+		clip->addPositionKey(0.5f, {5, 5, 5});
+		clip->addPositionKey(1.0f, {0, 0, 0});
+		return clip;
+	}();
+
+	return clip;
+}
+
+/*
+ * AnimationSystem
+ */
+
+static void lerp(float* from, const float* to, const float* alpha, size_t count) {
+	for (size_t i = 0; i < count; i ++) {
+		from[i] += (to[i] - from[i]) * alpha[i];
+	}
+}
+
+static void scale(float* values, const float* factors, size_t count) {
+	for (size_t i = 0; i < count; i ++) {
+		values[i] *= factors[i];
+	}
+}
+
+void AnimationSystem::gather(AnimationClip::Channel channel) {
+	sampled.clear();
+	alpha.clear();
+
+	for (size_t c = 0; c < 4; c ++) {
+		from[c].clear();
+		to[c].clear();
+	}
+
+	for (uint32_t i = 0; i < owners.size(); i ++) {
+		const AnimationClip::Track& track = clips[i]->getTrack(channel);
+
+		if (track.times.empty()) {
+			continue;
+		}
+
+		const float time = times[i];
+		const uint32_t last = track.times.size() - 1;
+		uint32_t& cursor = cursors[channel][i];
+
+		// time only moves forward between wraps, so the previous key pair is usually still the right one
+		if (cursor >= last || track.times[cursor] > time || track.times[cursor + 1] <= time) {
+			const auto it = std::ranges::upper_bound(track.times, time);
+			cursor = it == track.times.begin() ? 0 : (it - track.times.begin()) - 1;
+		}
+
+		const uint32_t next = std::min(cursor + 1, last);
+		const float span = track.times[next] - track.times[cursor];
+		const float factor = span > 0 ? (time - track.times[cursor]) / span : 0;
+
+		const glm::vec4& a = track.values[cursor];
+		const glm::vec4& b = track.values[next];
+
+		sampled.push_back(i);
+		alpha.push_back(std::min(std::max(factor, 0.0f), 1.0f));
+
+		from[0].push_back(a.x); from[1].push_back(a.y); from[2].push_back(a.z); from[3].push_back(a.w);
+		to[0].push_back(b.x); to[1].push_back(b.y); to[2].push_back(b.z); to[3].push_back(b.w);
+	}
+}
+
+void AnimationSystem::interpolate(AnimationClip::Channel channel) {
+	const size_t count = sampled.size();
+	factors.resize(count);
+
+	// each loop touches only a few arrays, so the compiler can vectorize it with a cheap aliasing check
+	const float* ax = from[0].data(); const float* ay = from[1].data(); const float* az = from[2].data(); const float* aw = from[3].data();
+	const float* bx = to[0].data(); const float* by = to[1].data(); const float* bz = to[2].data(); const float* bw = to[3].data();
+	float* factor = factors.data();
+
+	if (channel == AnimationClip::ROTATION) {
+
+		// take the shorter arc, the sign flip is branchless so that the loop stays vectorizable
+		for (size_t i = 0; i < count; i ++) {
+			factor[i] = std::copysign(1.0f, ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i] + aw[i] * bw[i]);
+		}
+
+		for (std::vector<float>& component : to) {
+			scale(component.data(), factor, count);
+		}
+	}
+
+	// results are written over the 'from' buffers
+	for (size_t c = 0; c < 4; c ++) {
+		lerp(from[c].data(), to[c].data(), alpha.data(), count);
+	}
+
+	if (channel == AnimationClip::ROTATION) {
+		for (size_t i = 0; i < count; i ++) {
+			factor[i] = 1.0f / std::sqrt(ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i] + aw[i] * aw[i]);
+		}
+
+		for (std::vector<float>& component : from) {
+			scale(component.data(), factor, count);
+		}
+	}
+}
+
+void AnimationSystem::apply(AnimationClip::Channel channel) {
+	for (size_t j = 0; j < sampled.size(); j ++) {
+		const uint32_t i = sampled[j];
+		SpatialPawn* pawn = owners[i]->getSpatialParent();
+		const glm::vec3 value {from[0][j], from[1][j], from[2][j]};
+
+		switch (channel) {
+			case AnimationClip::POSITION:
+				if (clips[i]->isAdditive()) {
+					pawn->setPosition(pawn->getPosition() + (value - offsets[i]));
+					offsets[i] = value;
+				} else {
+					pawn->setPosition(value);
+				}
+				break;
+			case AnimationClip::ROTATION:
+				pawn->setRotation(glm::quat {from[3][j], from[0][j], from[1][j], from[2][j]});
+				break;
+			case AnimationClip::SCALE:
+				pawn->setScale(value);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+AnimationSystem::~AnimationSystem() {
+	for (MatrixAnimation* animation : owners) {
+		animation->time = times[animation->index];
+		animation->system = nullptr;
+	}
+}
+
+void AnimationSystem::insert(MatrixAnimation* animation) {
+	if (animation->system == this) {
+		return;
+	}
+
+	if (animation->system != nullptr) {
+		animation->system->remove(animation);
+	}
+
+	animation->system = this;
+	animation->index = owners.size();
+
+	owners.push_back(animation);
+	clips.push_back(nullptr);
+	times.push_back(animation->time);
+	speeds.push_back(0);
+	durations.push_back(1);
+	offsets.emplace_back(0);
+
+	for (std::vector<uint32_t>& cursor : cursors) {
+		cursor.push_back(0);
+	}
+
+	refresh(animation, false);
+}
+
+void AnimationSystem::remove(MatrixAnimation* animation) {
+	if (animation->system != this) {
+		return;
+	}
+
+	const uint32_t index = animation->index;
+	const uint32_t last = owners.size() - 1;
+
+	// keep the playback time, so that the animation continues if it's added again
+	animation->time = times[index];
+	animation->system = nullptr;
+
+	owners[index] = owners[last];
+	clips[index] = clips[last];
+	times[index] = times[last];
+	speeds[index] = speeds[last];
+	durations[index] = durations[last];
+	offsets[index] = offsets[last];
+
+	for (std::vector<uint32_t>& cursor : cursors) {
+		cursor[index] = cursor[last];
+		cursor.pop_back();
+	}
+
+	owners[index]->index = index;
+
+	owners.pop_back();
+	clips.pop_back();
+	times.pop_back();
+	speeds.pop_back();
+	durations.pop_back();
+	offsets.pop_back();
+}
+
+void AnimationSystem::refresh(MatrixAnimation* animation, bool restart) {
+	if (animation->system != this) {
+		return;
+	}
+
+	const uint32_t index = animation->index;
+	const AnimationClip* clip = animation->clip.get();
+
+	// the empty clip keeps the arrays free of null checks
+	static const AnimationClip empty {1.0f};
+
+	if (clip == nullptr) {
+		clip = &empty;
+	}
+
+	if (clips[index] != clip || restart) {
+		clips[index] = clip;
+		times[index] = animation->time;
+		offsets[index] = glm::vec3(0);
+
+		for (std::vector<uint32_t>& cursor : cursors) {
+			cursor[index] = 0;
+		}
+	}
+
+	speeds[index] = animation->speed;
+	durations[index] = clip->getDuration();
+}
+
+void AnimationSystem::update(float delta) {
+	const size_t count = owners.size();
+
+	if (count == 0) {
+		return;
+	}
+
+	float* time = times.data();
+	const float* speed = speeds.data();
+	const float* duration = durations.data();
+
+	for (size_t i = 0; i < count; i ++) {
+		const float advanced = time[i] + delta * speed[i];
+		time[i] = advanced - duration[i] * std::floor(advanced / duration[i]);
+	}
+
+	for (size_t channel = 0; channel < AnimationClip::CHANNELS; channel ++) {
+		const auto typed = static_cast<AnimationClip::Channel>(channel);
+
+		gather(typed);
+		interpolate(typed);
+		apply(typed);
+	}
+}
+
+size_t AnimationSystem::size() const {
+	return owners.size();
+}
+
+float AnimationSystem::getTime(uint32_t index) const {
+	return times[index];
+}
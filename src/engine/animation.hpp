@@ -0,0 +1,155 @@
+#pragma once
+#include "external.hpp"
+
+class MatrixAnimation;
+
+/**
+ * Keyframe curves of position, rotation and scale, clips are immutable once shared,
+ * so a single clip can drive any number of MatrixAnimation components
+ */
+class AnimationClip {
+public:
+	enum Channel {
+		POSITION = 0,
+		ROTATION = 1,
+		SCALE = 2
+	};
+
+	static constexpr size_t CHANNELS = 3;
+
+	/**
+	 * keyframes of one channel sorted by time, vectors are stored as (x, y, z, 0) and quaternions as (x, y, z, w)
+	 */
+	struct Track {
+		std::vector<float> times;
+		std::vector<glm::vec4> values;
+	};
+
+protected:
+	Track tracks[CHANNELS];
+	float duration;
+	bool additive;
+
+	void addKey(Channel channel, float time, glm::vec4 value);
+
+public:
+	/**
+	 * creates an empty clip of the given length in seconds, additive clips move the pawn by the change of the
+	 * sampled position (so they can be combined with other motion) instead of setting it
+	 */
+	AnimationClip(float duration, bool additive = false);
+
+	/**
+	 * adds a position key, keys can be added in any order
+	 */
+	void addPositionKey(float time, glm::vec3 position);
+
+	/**
+	 * adds a rotation key, consecutive keys are interpolated along the shorter arc, so keep them less than half a turn apart
+	 */
+	void addRotationKey(float time, glm::quat rotation);
+
+	/**
+	 * adds a scale key, keys can be added in any order
+	 */
+	void addScaleKey(float time, glm::vec3 scale);
+
+	/**
+	 * returns the keyframes of the channel
+	 */
+	const Track& getTrack(Channel channel) const;
+
+	/**
+	 * returns the length of the clip in seconds, the clip loops after that
+	 */
+	float getDuration() const;
+
+	/**
+	 * returns true if the position of this clip is applied as an offset
+	 */
+	bool isAdditive() const;
+
+	/**
+	 * full turn around the (1, 1, 1) axis every second
+	 */
+	static std::shared_ptr<const AnimationClip> rotation();
+
+	/**
+	 * additive back and forth movement along the (1, 1, 1) axis every second
+	 */
+	static std::shared_ptr<const AnimationClip> translation();
+};
+
+/**
+ * Samples all the MatrixAnimation components of a board in one pass per fixed update, the state of every
+ * animation lives in contiguous arrays and the interpolation runs over structure-of-arrays scratch buffers,
+ * so the compiler can vectorize it, only the final write to the pawn is done one animation at a time
+ */
+class AnimationSystem {
+protected:
+	std::vector<MatrixAnimation*> owners;
+	std::vector<const AnimationClip*> clips;
+	std::vector<float> times;
+	std::vector<float> speeds;
+	std::vector<float> durations;
+	std::vector<uint32_t> cursors[AnimationClip::CHANNELS];
+	std::vector<glm::vec3> offsets;
+
+	// sampling scratch, one entry per animation that has keys in the sampled channel
+	std::vector<uint32_t> sampled;
+	std::vector<float> alpha;
+	std::vector<float> from[4];
+	std::vector<float> to[4];
+	std::vector<float> factors;
+
+	/**
+	 * finds the key pair around the time of each animation and gathers it into the scratch buffers
+	 */
+	void gather(AnimationClip::Channel channel);
+
+	/**
+	 * interpolates all the gathered key pairs, rotations are normalized
+	 */
+	void interpolate(AnimationClip::Channel channel);
+
+	/**
+	 * writes the interpolated values to the pawns
+	 */
+	void apply(AnimationClip::Channel channel);
+
+public:
+	AnimationSystem() = default;
+	AnimationSystem(const AnimationSystem& other) = delete;
+
+	~AnimationSystem();
+
+	/**
+	 * adds the animation to the system, its state is copied into the system arrays
+	 */
+	void insert(MatrixAnimation* animation);
+
+	/**
+	 * removes the animation, the last animation takes its place
+	 */
+	void remove(MatrixAnimation* animation);
+
+	/**
+	 * copies the clip and speed of the animation into the system arrays, with restart set the clip is played from the start
+	 */
+	void refresh(MatrixAnimation* animation, bool restart);
+
+	/**
+	 * advances and samples all the animations
+	 */
+	void update(float delta);
+
+	/**
+	 * returns the number of animations in the system
+	 */
+	size_t size() const;
+
+	/**
+	 * returns the playback time of the animation at the given index in seconds
+	 */
+	float getTime(uint32_t index) const;
+};
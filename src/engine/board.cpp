@@ -1,16 +1,22 @@
 #include "board.hpp"
 #include "entity/pawns/spatialPawn.hpp"
 #include "shared/logger.hpp"
+#include "headless.hpp"
 
 /*
  * Board
  */
 
 Board::Board() {
-	SoundManager::getInstance(); //unfortunately sound system is kinda cooked, so I need to do this
+	parallel_update = false;
+
+	if (!Headless::isEnabled()) {
+		SoundManager::getInstance(); //unfortunately sound system is kinda cooked, so I need to do this
+	}
+
 	pawns_to_remove = new std::queue<std::shared_ptr<Pawn>>();
-	pawns_to_remove_from_hashmap = new std::queue<std::shared_ptr<Pawn>>();
 	components_to_remove = new std::queue<std::shared_ptr<Component>>();
+	pawns.getRoot()->setBoard(this);
 }
 
 void Board::queueRemove(const std::shared_ptr<Pawn>& p_to_remove) const {
@@ -19,26 +25,49 @@ void Board::queueRemove(const std::shared_ptr<Pawn>& p_to_remove) const {
 		FAULT("Pawn unprepared to be removed!");
 	}
 #endif
-	if (p_to_remove->is_tracked_on_hash) {
-		//pawn needs to be removed from hashmap
-		pawns_to_remove->push(p_to_remove);
-		pawns_to_remove_from_hashmap->push(p_to_remove);
-	} else {
-		pawns_to_remove->push(p_to_remove);
-	}
+
+	// thread-safe pawns can remove themselves during the parallel update
+	std::lock_guard lock {remove_mutex};
+	pawns_to_remove->push(p_to_remove);
 }
 
 void Board::queueRemove(const std::shared_ptr<Component>& pawns_to_remove) {
+	std::lock_guard lock {remove_mutex};
 	components_to_remove->push(pawns_to_remove);
 }
 
-void Board::updateBoard(double delta, std::mutex& mtx) {
-	pawns.updateTree(delta, mtx);
+void Board::updateBoard(double delta, std::mutex& mtx, PhasedTaskDelegator& delegator) {
+	pawns.updateTree(delta, mtx, parallel_update ? &delegator : nullptr, getCamPos());
+}
+
+void Board::syncListener() {
+	if (Headless::isEnabled()) {
+		return;
+	}
+
 	SoundListener::setPosition(this->getCamPos());
 	SoundListener::setOrientation(this->getCamForward(), {0.0f,1.0f,0.0f});
 }
 
 
+size_t Board::deliverMessages() {
+	return messages.deliver([this] (uint64_t receiver, std::span<Message* const> batch) {
+
+		// the pawn is looked up once for all its messages
+		if (Pawn* pawn = getPawn(fromReceiver(receiver))) {
+			pawn->receive(batch);
+		}
+	});
+}
+
+uint64_t Board::toReceiver(PawnHandle handle) {
+	return (static_cast<uint64_t>(handle.index) << 32) | handle.generation;
+}
+
+PawnHandle Board::fromReceiver(uint64_t receiver) {
+	return {static_cast<uint32_t>(receiver >> 32), static_cast<uint32_t>(receiver)};
+}
+
 void Board::fixedUpdateBoard() {
 	pawns.fixedUpdateTree();
 }
@@ -50,6 +79,14 @@ void Board::addPawnToRoot(const std::shared_ptr<Pawn>& pawn) {
 }
 
 
+void Board::addPawnsToRoot(const std::vector<std::shared_ptr<Pawn>>& batch) {
+	pawns.addToRoot(batch);
+
+	for (const std::shared_ptr<Pawn>& pawn : batch) {
+		pawn->setBoard(this);
+	}
+}
+
 std::shared_ptr<Pawn> Board::findPawnByID(const uint32_t id) {
 	return pawns.findByID(id);
 }
@@ -113,6 +150,47 @@ std::vector<std::shared_ptr<Pawn>> Board::findPawnsByName(const std::string& nam
 }
 
 
+std::shared_ptr<Pawn> Board::findPawnByName(const Atom name) {
+	return pawns.findByName(name);
+}
+
+
+std::vector<std::shared_ptr<Pawn>> Board::findPawnsByName(const Atom name) {
+	return pawns.findAllByName(name);
+}
+
+
+Pawn* Board::getPawn(const PawnHandle handle) {
+	return pawns.getPawn(handle);
+}
+
+
+Component* Board::getComponent(const ComponentHandle handle) {
+	return pawns.getComponent(handle);
+}
+
+
+std::vector<SpatialPawn*> Board::findPawnsInRadius(const glm::vec3 center, const float radius) {
+	std::vector<SpatialPawn*> result;
+	pawns.getSpatialIndex().findInRadius(center, radius, result);
+	return result;
+}
+
+
+std::vector<SpatialPawn*> Board::findPawnsInBox(const glm::vec3 min, const glm::vec3 max) {
+	std::vector<SpatialPawn*> result;
+	pawns.getSpatialIndex().findInBox(min, max, result);
+	return result;
+}
+
+
+std::vector<SpatialPawn*> Board::findNearestPawns(const glm::vec3 center, const size_t k) {
+	std::vector<SpatialPawn*> result;
+	pawns.getSpatialIndex().findNearest(center, k, result);
+	return result;
+}
+
+
 void Board::printBoardTree() {
 	out::debug("Entity Tree:\n%s", (pawns.toString() + " ").c_str());
 }
@@ -135,71 +213,62 @@ void Board::setCameraPawn(const std::shared_ptr<SpatialPawn>& new_camera_pawn) {
 }
 
 glm::vec3 Board::getCamPos() const {
-	return camera_pawn.lock()->getPosition();
+	if (auto camera = camera_pawn.lock()) {
+		return camera->getPosition();
+	}
+
+	return {0, 0, 0};
 }
 
 glm::vec3 Board::getCamForward() const {
-	return camera_pawn.lock()->getForwardVector();
+	if (auto camera = camera_pawn.lock()) {
+		return camera->getForwardVector();
+	}
+
+	return glm::normalize(math::calculateForwardVector(glm::quat {1, 0, 0, 0}));
 }
 
 Board::~Board() {
 	delete pawns_to_remove;
-	delete pawns_to_remove_from_hashmap;
+	delete components_to_remove;
 }
 
-void Board::dequeueRemove(const size_t amount) {
-	while (!pawns_to_remove->empty()) {
-		std::shared_ptr<Pawn> to_be_removed = pawns_to_remove->front();
+void Board::dequeueRemove() {
 
-		std::destroy(to_be_removed->children.begin(), to_be_removed->children.end());
+	// the transform queue holds raw pointers, so it must be empty before any pawn is destroyed
+	pawns.flushTransforms();
 
-		if (std::weak_ptr parent = to_be_removed->parent; !parent.expired()) {
-			auto& children = parent.lock()->getChildren();
-			std::erase_if(children,
-			              [id = to_be_removed->id](const std::shared_ptr<Pawn>& x) {
-				              return x->id == id;
-			              });
-		}
-
-		to_be_removed->parent.reset();
+	// every step here is O(1) per removed pawn, so mass removals can all be processed in the same frame
+	while (!pawns_to_remove->empty()) {
+		std::shared_ptr<Pawn> to_be_removed = std::move(pawns_to_remove->front());
+		pawns_to_remove->pop();
 
-#if ENGINE_DEBUG
-		if (!to_be_removed.get()->is_tracked_on_hash) {
-			//pawn should die here
-			std::weak_ptr<Pawn> check = to_be_removed;
-			pawns_to_remove->pop();
-
-			if (!check.expired()) {
-				FAULT("There is some reference to a pawn, not good...");
-			}
-		} else {
-			pawns_to_remove->pop();
+		if (std::shared_ptr<Pawn> parent = to_be_removed->parent.lock()) {
+			parent->detachChild(to_be_removed.get());
 		}
 
-#else
-        pawns_to_remove->pop();
-#endif
+		to_be_removed->parent.reset();
+		pawns.unmountPawn(to_be_removed);
 	}
-	for (size_t i = 0;
-	     i < (pawns_to_remove_from_hashmap->size() > amount ? amount : pawns_to_remove_from_hashmap->size()); i++) {
-		const std::shared_ptr<Pawn> to_be_removed = pawns_to_remove_from_hashmap->front();
 
-#if ENGINE_DEBUG
-		if (!to_be_removed.get()->is_tracked_on_hash) {
-			FAULT("Trying to remove pawn from hashmap that is explicitly mark for net being in the hashmap");
-		}
-#endif
-		pawns.removeFromMaps(to_be_removed->name, to_be_removed->id);
+	// components are released together with their pawns
+	*components_to_remove = {};
+}
 
-		pawns_to_remove_from_hashmap->pop();
-	}
-	for (size_t i = 0; i < (components_to_remove->size() > amount ? amount : components_to_remove->size()); i++) {
-		std::shared_ptr<Component>* to_be_removed = &components_to_remove->front();
+void Board::setParallelUpdate(const bool value) {
+	parallel_update = value;
+}
 
-		//todo removing from components hashmap after adding it
+bool Board::isParallelUpdate() const {
+	return parallel_update;
+}
 
-		components_to_remove->pop();
-	}
+void Board::setUpdateScheduling(const bool value) {
+	pawns.getScheduler().setEnabled(value);
+}
+
+UpdateScheduler& Board::getUpdateScheduler() {
+	return pawns.getScheduler();
 }
 
 int Board::pawnsToRemove() const {
@@ -13,9 +13,11 @@ private:
 	std::weak_ptr<SpatialPawn> camera_pawn;
 	std::string name;
 	std::queue<std::shared_ptr<Pawn>>* pawns_to_remove;
-	std::queue<std::shared_ptr<Pawn>>* pawns_to_remove_from_hashmap;
 	std::queue<std::shared_ptr<Component>>* components_to_remove;
+	mutable std::mutex remove_mutex;
 	SoundListener sound_listener;
+	MessageBus messages;
+	bool parallel_update;
 
 	/**
 	 * queue remove a pawn
@@ -27,7 +29,16 @@ private:
 	 */
 	void queueRemove(const std::shared_ptr<Component>& pawns_to_remove);
 
-	void dequeueRemove(size_t amount);
+	/**
+	 * removes all the queued pawns and their subtrees from the board in one batch
+	 */
+	void dequeueRemove();
+
+	/**
+	 * message bus receivers are packed pawn handles
+	 */
+	static uint64_t toReceiver(PawnHandle handle);
+	static PawnHandle fromReceiver(uint64_t receiver);
 
 public:
 	Board();
@@ -35,20 +46,46 @@ public:
 	~Board();
 
 	/**
-	 * performs standard update on a pawn tree
+	 * performs standard update on a pawn tree, thread-safe pawns are updated using the given delegator if parallel update is enabled
+	 */
+	void updateBoard(double delta, std::mutex& mtx, PhasedTaskDelegator& delegator);
+
+	/**
+	 * moves the sound listener to the camera of this board, only the current board should own the listener
 	 */
-	void updateBoard(double delta, std::mutex& mtx);
+	void syncListener();
 
 	/**
 	 * performs fixed update on a pawn tree
 	 */
 	void fixedUpdateBoard();
 
+	/**
+	 * posts a message to the pawn, can be called from any thread (including parallel updates) without locking,
+	 * small messages are stored inline so posting them doesn't allocate, the pawn receives the message in its listener
+	 * at the next phase boundary, messages to pawns that were removed by then are dropped, see Pawn::listen()
+	 */
+	template <typename T>
+	void post(PawnHandle receiver, T&& message) {
+		messages.post(toReceiver(receiver), std::forward<T>(message));
+	}
+
+	/**
+	 * delivers all the posted messages grouped by their receivers, called on the main thread after the update and fixed update
+	 * phases, messages posted by the listeners are delivered at the next boundary, returns the number of delivered messages
+	 */
+	size_t deliverMessages();
+
 	/**
 	 * adds a pawn as a child of pawn tree
 	 */
 	void addPawnToRoot(const std::shared_ptr<Pawn>& pawn);
 
+	/**
+	 * adds all the pawns as children of pawn tree in one batch
+	 */
+	void addPawnsToRoot(const std::vector<std::shared_ptr<Pawn>>& batch);
+
 	/**
 	 * returns first pawn by its id
 	 */
@@ -89,6 +126,49 @@ public:
 	 */
 	std::vector<std::shared_ptr<Pawn>> findPawnsByName(const std::string& name);
 
+	/**
+	 * returns first pawn by its interned name, use this for lookups repeated every frame
+	 */
+	std::shared_ptr<Pawn> findPawnByName(Atom name);
+
+	/**
+	 * returns all pawns with certain interned name
+	 */
+	std::vector<std::shared_ptr<Pawn>> findPawnsByName(Atom name);
+
+	/**
+	 * returns pawn by its handle, or nullptr if the pawn was removed from the board
+	 */
+	Pawn* getPawn(PawnHandle handle);
+
+	/**
+	 * returns component by its handle, or nullptr if the component was removed from the board
+	 */
+	Component* getComponent(ComponentHandle handle);
+
+	/**
+	 * returns all pawns that have components of all the given classes (as created with createComponent())
+	 */
+	template<DerivedTrait<Component>... T>
+	std::vector<Pawn*> findPawnsWithComponents() {
+		return pawns.findPawnsWithComponents(ComponentSignature::of<T...>());
+	}
+
+	/**
+	 * returns all spatial pawns within the radius, positions are the world positions as of the last update
+	 */
+	std::vector<SpatialPawn*> findPawnsInRadius(glm::vec3 center, float radius);
+
+	/**
+	 * returns all spatial pawns inside the axis aligned box, positions are the world positions as of the last update
+	 */
+	std::vector<SpatialPawn*> findPawnsInBox(glm::vec3 min, glm::vec3 max);
+
+	/**
+	 * returns up to k spatial pawns closest to the center, sorted by distance
+	 */
+	std::vector<SpatialPawn*> findNearestPawns(glm::vec3 center, size_t k);
+
 	/**
 	 * DEBUG ONLY - prints whole pawn tree (DON'T USE IN RELEASE VERSION)
 	 */
@@ -115,15 +195,35 @@ public:
 	void setCameraPawn(const std::shared_ptr<SpatialPawn>& new_camera_pawn);
 
 	/**
-	 * return position of camera component
+	 * return position of camera component, or the origin if the board has no camera
 	 */
 	glm::vec3 getCamPos() const;
 
 	/**
-	 * return facing vector of camera component
+	 * return facing vector of camera component, or the forward vector of an unrotated pawn if the board has no camera
 	 */
 	glm::vec3 getCamForward() const;
 
+	/**
+	 * enables or disables concurrent update of pawns marked as thread-safe, disabled by default
+	 */
+	void setParallelUpdate(bool value);
+
+	/**
+	 * returns true if thread-safe pawns are updated concurrently
+	 */
+	bool isParallelUpdate() const;
+
+	/**
+	 * enables or disables distance based update tiers and the frame budget, disabled by default, see UpdateScheduler
+	 */
+	void setUpdateScheduling(bool value);
+
+	/**
+	 * returns the scheduler that decides which pawns are updated in each frame
+	 */
+	UpdateScheduler& getUpdateScheduler();
+
 	/**
 	 * return list of pawns to remove
 	 */
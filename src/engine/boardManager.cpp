@@ -5,6 +5,10 @@
 #include "shared/logger.hpp"
 #include <chrono>
 #include "physics/physicsEngine.hpp"
+#include "snapshot.hpp"
+#include "shared/mapped.hpp"
+#include "shared/arena.hpp"
+#include "headless.hpp"
 
 /*
  * BoardManager
@@ -17,10 +21,14 @@ BoardManager::BoardManager(const std::shared_ptr<InputDispatcher>& disp): physic
 	addBoard(new_board);
 
 	continue_loop = true;
+	preparing_boards = 0;
+	background_interval = 0;
+	background_delta = 0;
 	task_delegator = std::make_unique<PhasedTaskDelegator>(task_pool);
 	global_tick_number = 0;
 
 	standardSetup();
+	setupFrameGraph();
 }
 
 BoardManager::~BoardManager() {
@@ -43,11 +51,115 @@ void BoardManager::standardSetup() {
 	cb->addPawnToRoot(cameraPawn);
 }
 
+void BoardManager::setupFrameGraph() {
+
+	// pawn code can touch the render system, so everything that runs it stays on the main thread
+	frame_graph.add("update", {}, {"pawns", "camera"}, [this] () {
+		frame_board->updateBoard(frame_delta, physics_mutex, *task_delegator);
+	}, true);
+
+	// messages are delivered at the phase boundaries, so pawns receive them after all the posters ran,
+	// every job that runs pawn code can move the camera pawn, so all of them write the camera
+	frame_graph.add("update messages", {}, {"pawns", "camera"}, [this] () {
+		frame_board->deliverMessages();
+	}, true);
+
+	frame_graph.add("fixed update", {}, {"pawns", "camera"}, [this] () {
+		if (frame_physics) frame_board->fixedUpdateBoard();
+	}, true);
+
+	frame_graph.add("fixed update messages", {}, {"pawns", "camera"}, [this] () {
+		if (frame_physics) frame_board->deliverMessages();
+	}, true);
+
+	frame_graph.add("physics", {}, {"pawns", "physics"}, [this] () {
+		if (frame_physics) physics_engine.physicsUpdate();
+	});
+
+	// physics doesn't move the camera, so the listener follows it after the last pawn code ran, in parallel with physics
+	frame_graph.add("sound sync", {"camera"}, {"listener"}, [this] () {
+		frame_board->syncListener();
+	});
+
+	frame_graph.add("background boards", {}, {"background"}, [this] () {
+		updateBackgroundBoards(frame_delta, frame_board);
+	}, true);
+
+	frame_graph.add("removal", {}, {"pawns", "physics", "camera"}, [this] () {
+		if (frame_board->pawnsToRemove() > 0) {
+			std::lock_guard lock {physics_mutex};
+			frame_board->dequeueRemove();
+		}
+	}, true);
+}
+
 void BoardManager::addBoard(const std::shared_ptr<Board>& new_board) {
 	boardList.push_back(new_board);
 	current_board = new_board;
 }
 
+void BoardManager::adoptPreparedBoards() {
+	std::vector<PreparedBoard> prepared;
+
+	{
+		std::lock_guard lock {prepared_mutex};
+		prepared.swap(prepared_boards);
+	}
+
+	for (PreparedBoard& entry : prepared) {
+		preparing_boards --;
+
+		try {
+			entry.bindings->apply();
+
+			if (entry.finisher) {
+				entry.finisher(*entry.board);
+			}
+		} catch (...) {
+			out::error("Failed to finish preparing a board, the board was discarded!");
+			entry.promise->set_exception(std::current_exception());
+			continue;
+		}
+
+		boardList.push_back(entry.board);
+
+		if (entry.activate) {
+			current_board = entry.board;
+		}
+
+		entry.promise->set_value(entry.board);
+	}
+}
+
+void BoardManager::updateBackgroundBoards(double delta, const std::shared_ptr<Board>& current) {
+	if (background_interval == 0) {
+		return;
+	}
+
+	background_delta += delta;
+
+	if (global_tick_number % background_interval != 0) {
+		return;
+	}
+
+	for (const std::shared_ptr<Board>& board : boardList) {
+		if (board == current) {
+			continue;
+		}
+
+		board->updateBoard(background_delta, physics_mutex, *task_delegator);
+
+		// otherwise the messages of ticked background boards would pile up until the board becomes current
+		board->deliverMessages();
+
+		if (board->pawnsToRemove() > 0) {
+			board->dequeueRemove();
+		}
+	}
+
+	background_delta = 0;
+}
+
 void BoardManager::updateCycle() {
 	//-----------static------------
 
@@ -55,6 +167,15 @@ void BoardManager::updateCycle() {
 
 	//-----------initate-----------
 
+	// transient allocations of the previous frame are no longer in use
+	FrameArena::current().reset();
+
+	// boards finished in the background are only switched to at the frame boundary
+	adoptPreparedBoards();
+
+	// tasks enqueued while the queue executes run in the next frame
+	frame_queue.execute();
+
 	std::shared_ptr<Board> usingBoard;
 
 	if (!current_board.expired()) usingBoard = current_board.lock();
@@ -68,40 +189,21 @@ void BoardManager::updateCycle() {
 	//-----------update-------------
 
 	const auto now = std::chrono::high_resolution_clock::now();
-	usingBoard->updateBoard(std::chrono::duration<double>(now - before).count(), physics_mutex);
+	frame_delta = std::chrono::duration<double>(now - before).count();
 	before = now;
 
-
 	auto next_tick = std::chrono::steady_clock::now();
+	frame_physics = next_tick > physics_next_tick;
 
-	if (next_tick > physics_next_tick) {
+	if (frame_physics) {
 		physics_next_tick = next_tick + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
 			                    std::chrono::duration<double>(TICK_DURATION));
-
-		if (!current_board.expired()) {
-			current_board.lock()->fixedUpdateBoard();
-			physics_engine.physicsUpdate();
-		}
-	}
-
-	//------hardcoded updates-------
-
-	/*
-	auto p = std::make_shared<Pawn>();
-	usingBoard->addPawnToRoot(p);*/
-
-	//---communicate with renderer---
-
-
-	//-----------remove--------------
-
-	if (usingBoard->pawnsToRemove() > 0) {
-		//maybe someday it will be smarter
-		physics_mutex.lock();
-		usingBoard->dequeueRemove(100);
-		physics_mutex.unlock();
 	}
 
+	// update, fixed update, physics, sound sync and removal, see setupFrameGraph()
+	frame_board = usingBoard;
+	frame_graph.run(task_pool);
+	frame_board.reset();
 
 	//-----------debug---------------
 
@@ -179,6 +281,18 @@ std::shared_ptr<Board> BoardManager::findWorkingBoard(bool& success) {
 }
 
 
+const JobGraph& BoardManager::getFrameGraph() const {
+	return frame_graph;
+}
+
+TaskQueue& BoardManager::getFrameQueue() {
+	return frame_queue;
+}
+
+TaskPool& BoardManager::getTaskPool() {
+	return task_pool;
+}
+
 std::weak_ptr<Board> BoardManager::getCurrentBoard() {
 	return current_board;
 }
@@ -186,3 +300,62 @@ std::weak_ptr<Board> BoardManager::getCurrentBoard() {
 void BoardManager::setGravity(glm::vec3 gravity) {
 	physics_engine.setGravityScale(gravity);
 }
+
+std::shared_future<std::shared_ptr<Board>> BoardManager::prepareBoard(const BoardBuilder& builder, const BoardBuilder& finisher, bool activate) {
+	auto promise = std::make_shared<std::promise<std::shared_ptr<Board>>>();
+	std::shared_future<std::shared_ptr<Board>> future = promise->get_future().share();
+
+	preparing_boards ++;
+
+	// the board constructor can start the sound system, so it has to run here on the main thread
+	auto board = std::make_shared<Board>();
+
+	task_pool.enqueue([this, board, builder, finisher, activate, promise] () {
+		auto bindings = std::make_shared<BackendBindings>();
+
+		try {
+			BackendBindings::Scope scope {*bindings};
+			builder(*board);
+		} catch (...) {
+			out::error("Failed to prepare a board in the background!");
+			preparing_boards --;
+			promise->set_exception(std::current_exception());
+			return;
+		}
+
+		std::lock_guard lock {prepared_mutex};
+		prepared_boards.push_back({board, bindings, finisher, activate, promise});
+	}, TaskPriority::BACKGROUND);
+
+	return future;
+}
+
+std::shared_future<std::shared_ptr<Board>> BoardManager::streamBoard(const std::string& path, bool activate) {
+	const BoardBuilder builder = [path] (Board& board) {
+		MappedFile file;
+
+		if (!file.open(path)) {
+			throw std::runtime_error {"Failed to open board snapshot '" + path + "'!"};
+		}
+
+		// the whole hierarchy is created here, only the render and sound bindings are left for the hand-over
+		if (!BoardSnapshot::deserialize(board, file.data(), file.size())) {
+			throw std::runtime_error {"Failed to load board snapshot '" + path + "'!"};
+		}
+	};
+
+	return prepareBoard(builder, {}, activate);
+}
+
+bool BoardManager::isPreparingBoard() const {
+	return preparing_boards > 0;
+}
+
+void BoardManager::setCurrentBoard(const std::shared_ptr<Board>& board) {
+	current_board = board;
+}
+
+void BoardManager::setBackgroundUpdateInterval(uint32_t frames) {
+	background_interval = frames;
+	background_delta = 0;
+}
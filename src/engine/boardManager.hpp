@@ -6,6 +6,8 @@
 #include "render/window.hpp"
 #include "shared/thread/phased.hpp"
 #include "shared/thread/mailbox.hpp"
+#include "shared/thread/graph.hpp"
+#include "shared/thread/coroutine.hpp"
 
 
 enum BoardRevocery {
@@ -15,9 +17,23 @@ enum BoardRevocery {
 };
 
 class Board;
+class BackendBindings;
+
+using BoardBuilder = std::function<void(Board&)>;
 
 class BoardManager {
 protected:
+	/**
+	 * board built in the background, waiting for the start of a frame to be handed over
+	 */
+	struct PreparedBoard {
+		std::shared_ptr<Board> board;
+		std::shared_ptr<BackendBindings> bindings;
+		BoardBuilder finisher;
+		bool activate;
+		std::shared_ptr<std::promise<std::shared_ptr<Board>>> promise;
+	};
+
 	PhysicsEngine physics_engine;
 	unsigned long long global_tick_number;
 	std::weak_ptr<Board> current_board;
@@ -29,8 +45,22 @@ protected:
 
 	std::shared_ptr<InputDispatcher> dispatcher;
 
+	///boards prepared by the task pool, declared before the pool so that they outlive its workers
+	std::mutex prepared_mutex;
+	std::vector<PreparedBoard> prepared_boards;
+	std::atomic<size_t> preparing_boards;
+
+	///background boards are ticked every that many frames, 0 if they are not ticked at all
+	uint32_t background_interval;
+	double background_delta;
+
+	///tasks and coroutines to run on the main thread at the start of the next frame
+	TaskQueue frame_queue;
+
 	std::unique_ptr<PhasedTaskDelegator> task_delegator;
-	TaskPool task_pool;
+
+	///background tasks (board preparation) run on the I/O lane, so they never hold up the frame
+	TaskPool task_pool {TaskPool::optimal(), 1};
 	std::thread physics_thread;
 
 	std::mutex physics_mutex;
@@ -38,6 +68,17 @@ protected:
 	std::atomic<bool> continue_loop;
 	std::chrono::time_point<std::chrono::steady_clock> physics_next_tick;
 
+	///phases of a single frame, the jobs operate on the frame state below
+	JobGraph frame_graph;
+	std::shared_ptr<Board> frame_board;
+	double frame_delta;
+	bool frame_physics;
+
+	/*
+	 * Creates the jobs of the frame graph
+	 */
+	void setupFrameGraph();
+
 	/*
 	 * Creates standard setup of objects and components
 	 */
@@ -45,6 +86,16 @@ protected:
 
 	void addBoard(const std::shared_ptr<Board>& new_board);
 
+	/**
+	 * hands over all the boards prepared in the background, called at the start of a frame
+	 */
+	void adoptPreparedBoards();
+
+	/**
+	 * ticks all boards other than the current one at the background rate
+	 */
+	void updateBackgroundBoards(double delta, const std::shared_ptr<Board>& current);
+
 public:
 	BoardManager(const std::shared_ptr<InputDispatcher>& disp = nullptr);
 
@@ -70,8 +121,55 @@ public:
 	 */
 	std::weak_ptr<Board> getCurrentBoard();
 
+	/**
+	 * returns the graph of jobs executed in each frame, use it to get the critical path of the last frame
+	 */
+	const JobGraph& getFrameGraph() const;
+
+	/**
+	 * returns the queue executed on the main thread at the start of each frame, coroutines can
+	 * co_await tasks::resumeOn(manager.getFrameQueue()) to continue there in the next frame
+	 */
+	TaskQueue& getFrameQueue();
+
+	/**
+	 * returns the pool that runs the jobs of the frame and the background work
+	 */
+	TaskPool& getTaskPool();
+
 	/**
 	 * sets gravity vector
 	 */
 	void setGravity(glm::vec3 gravity);
+
+	/**
+	 * builds a new board on a worker thread, so that the frame loop doesn't stall, the builder can create pawns, components, read files and
+	 * set up physics, but must not touch the render or sound systems directly as they are not thread-safe, render and sound components
+	 * created by the builder bind to them at the hand-over (see BackendBindings), other such work goes into the finisher,
+	 * both run on the main thread at the start of the first frame after the builder is done, then the board is added to the
+	 * manager and, if activate is set, becomes the current board, the future is ready after the hand-over
+	 */
+	std::shared_future<std::shared_ptr<Board>> prepareBoard(const BoardBuilder& builder, const BoardBuilder& finisher = {}, bool activate = true);
+
+	/**
+	 * loads a board snapshot in the background, the file is read and all its pawns and components are created on a worker thread,
+	 * only the render and sound objects are created at the hand-over, see prepareBoard() and BoardSnapshot
+	 */
+	std::shared_future<std::shared_ptr<Board>> streamBoard(const std::string& path, bool activate = true);
+
+	/**
+	 * returns true while any board is being prepared in the background
+	 */
+	bool isPreparingBoard() const;
+
+	/**
+	 * makes the board (which needs to be a part of this manager) current from the next frame on
+	 */
+	void setCurrentBoard(const std::shared_ptr<Board>& board);
+
+	/**
+	 * sets how often boards other than the current one are updated, every given number of frames, 0 (the default)
+	 * pauses them, background boards receive the whole time since their last update but skip fixed update and physics
+	 */
+	void setBackgroundUpdateInterval(uint32_t frames);
 };
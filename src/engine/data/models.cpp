@@ -1,6 +1,13 @@
 #include "models.hpp"
+#include "engine/headless.hpp"
+#include "shared/logger.hpp"
 
 void Models::init() {
+	if (!Headless::hasRenderer()) {
+		out::warn("Models not loaded, no renderer available!");
+		return;
+	}
+
 	initialized = true;
 	RenderSystem& system = *RenderSystem::system;
 
@@ -8,9 +15,14 @@ void Models::init() {
 }
 
 std::shared_ptr<RenderModel> Models::getShape(const Shape s) {
+	if (!initialized) {
+		return nullptr;
+	}
+
 	return models[static_cast<int>(s)];
 }
 
 void Models::terminate() {
 	models.clear();
+	initialized = false;
 }
@@ -22,3 +22,7 @@
 #include "board.hpp"
 #include "boardManager.hpp"
 #include "pawnTree.hpp"
+#include "snapshot.hpp"
+#include "prefab.hpp"
+#include "animation.hpp"
+#include "headless.hpp"
@@ -1,11 +1,46 @@
 #include "component.hpp"
 #include "pawn.hpp"
 #include "context.hpp"
+#include "pawns/rootPawn.hpp"
+#include "../pawnTree.hpp"
+#include "../storage.hpp"
 
 /*
  * Component
  */
 
+Component::~Component() {
+	ComponentArray::removeFromAll(this);
+}
+
+void Component::setTicking(const uint8_t phases) {
+	if (ticking == phases) {
+		return;
+	}
+
+	ticking = phases;
+
+	// if the component is a part of a tree move it to the correct tick lists
+	if (parent != nullptr && parent->isRooted()) {
+		parent->getRoot()->getTree()->registerComponent(this);
+	}
+}
+
+uint8_t Component::getTicking() const {
+	return ticking;
+}
+
+ComponentHandle Component::getHandle() const {
+	return handle;
+}
+
+uint32_t Component::getTypeId() const {
+	return type_id;
+}
+
+void Component::onTransformChanged() {
+}
+
 std::string Component::getComponentName() const {
 	return std::remove_reference_t<decltype(*this)>::class_name;
 }
@@ -3,17 +3,98 @@
 #include "input/input.hpp"
 #include "../trait.hpp"
 #include "render/render.hpp"
+#include "shared/slotmap.hpp"
 
 struct Context;
 struct FixedContext;
 class Pawn;
+class PawnTree;
+class Component;
+class ComponentArray;
+
+using ComponentHandle = Handle<Component*>;
+
+/**
+ * Small sequential ids of component classes, every class gets its id on first use and keeps it for the rest of
+ * the program, the ids are not stable between runs, so don't persist them (snapshots use type names instead)
+ */
+class ComponentTypeId {
+	inline static std::atomic<uint32_t> next = 0;
+
+public:
+	static constexpr uint32_t INVALID = UINT32_MAX;
+
+	template<typename T>
+	static uint32_t of() {
+		static const uint32_t id = next ++;
+		return id;
+	}
+};
+
+/**
+ * Set of component classes, a pawn has a signature of all the component classes it has, so systems can select
+ * pawns by the components they need, only the first 64 component classes fit in a signature
+ */
+struct ComponentSignature {
+	static constexpr uint32_t BITS = 64;
+
+	uint64_t mask = 0;
+
+	template<typename... T>
+	static ComponentSignature of() {
+		ComponentSignature signature;
+		((signature.mask |= bit(ComponentTypeId::of<T>())), ...);
+		return signature;
+	}
+
+	static uint64_t bit(uint32_t id) {
+		return id < BITS ? (uint64_t) 1 << id : 0;
+	}
+
+	/**
+	 * checks if all the classes of the other signature are also a part of this one
+	 */
+	bool contains(ComponentSignature other) const {
+		return (mask & other.mask) == other.mask;
+	}
+};
+
+/**
+ * Position of a component in one of the dense ComponentArrays
+ */
+struct ComponentSlot {
+	enum Type : uint8_t {
+		UPDATE = 0,
+		FIXED_UPDATE = 1
+	};
+
+	static constexpr size_t COUNT = 2;
+
+	ComponentArray* array = nullptr;
+	size_t index = 0;
+};
 
 class Component : public Entity, public InputListener {
 protected:
 	friend Pawn;
+	friend PawnTree;
+	friend ComponentArray;
+
 	///Pawn that owns this component
 	Pawn* parent;
 
+	///positions of this component in the tick lists of a PawnTree
+	ComponentSlot slots[ComponentSlot::COUNT];
+
+	///set of update phases in which the component is ticked
+	uint8_t ticking;
+
+	///generational handle of this component, assigned when the component becomes a part of a board
+	ComponentHandle handle;
+
+	///id of the class this component was created as, see Pawn::createComponent()
+	uint32_t type_id;
+
 	/**
 	 * All the things that happens on basic update of the engine (intervals between basic updates can vary)
 	 */
@@ -32,11 +113,52 @@ protected:
 	 */
 	virtual void onConnected() = 0;
 
+	/**
+	 * Executes after the world transform of the owning pawn (or one of its parents) changed, see SpatialPawn::getWorldMatrix()
+	 */
+	virtual void onTransformChanged();
+
 public:
+	/// Update phases in which the component can be ticked, can be combined
+	enum Tick : uint8_t {
+		TICK_NONE = 0b00,
+		TICK_UPDATE = 0b01,
+		TICK_FIXED_UPDATE = 0b10,
+	};
+
+	static constexpr uint8_t TICK_ALL = TICK_UPDATE | TICK_FIXED_UPDATE;
+
 	Component(Pawn* p) : Entity() {
 		parent = p;
+		ticking = TICK_ALL;
+		type_id = ComponentTypeId::INVALID;
 	}
 
+	~Component() override;
+
+	/**
+	 * Selects the update phases in which the component will be ticked, components that
+	 * don't tick in a phase are not a part of the board tick list of that phase and cost nothing to skip,
+	 * can be changed at any time
+	 */
+	void setTicking(uint8_t phases);
+
+	/**
+	 * Returns the update phases in which the component is ticked
+	 */
+	uint8_t getTicking() const;
+
+	/**
+	 * Returns a stable handle to this component that can be resolved with Board::getComponent(), the handle
+	 * expires when the component is removed from the board, empty if the component was never a part of one
+	 */
+	ComponentHandle getHandle() const;
+
+	/**
+	 * Returns the id of the class this component was created as, INVALID if it was added with Pawn::addComponent()
+	 */
+	uint32_t getTypeId() const;
+
 	/**
 	 * TODO make it into a virtual function, that returns const char* lub std::string_view, potentially remove name form entity???? check if that breaks sth in pawn
 	 */
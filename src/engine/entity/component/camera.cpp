@@ -22,6 +22,7 @@ Camera::Camera(SpatialPawn* s) : GameComponent(s) {
 	mouse_position = {0, 0};
 	mouse_position_old = {0, 0};
 	mouse_init = false;
+	ticking = TICK_UPDATE;
 }
 
 void Camera::onUpdate(Context c) {
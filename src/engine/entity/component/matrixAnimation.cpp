@@ -2,73 +2,89 @@
 #include "engine/entity/context.hpp"
 #include "engine/entity/pawns/spatialPawn.hpp"
 
-MatrixAnimation::MatrixAnimation(SpatialPawn* s) : GameComponent(s) {
-	animation_speed = 1;
-	old_percentage = 0;
-	percentage = 0;
-	type = NONE;
+MatrixAnimation::MatrixAnimation(SpatialPawn* s) : MatrixAnimation(s, NONE) {
 }
 
 MatrixAnimation::MatrixAnimation(SpatialPawn* s, const MatrixAnimation::AnimationType type) : GameComponent(s) {
-	animation_speed = 1;
-	old_percentage = 0;
-	percentage = 0;
-	this->type = type;
-}
+	speed = 1;
+	time = 0;
+	system = nullptr;
+	index = 0;
 
-void MatrixAnimation::setAnimation(const MatrixAnimation::AnimationType newType) {
-	type = newType;
+	// sampled by the AnimationSystem of the board
+	ticking = TICK_NONE;
+	setAnimation(type);
 }
 
-MatrixAnimation::AnimationType MatrixAnimation::getAnimation() const {
-	return type;
+MatrixAnimation::MatrixAnimation(SpatialPawn* s, const std::shared_ptr<const AnimationClip>& clip) : MatrixAnimation(s, NONE) {
+	setClip(clip);
 }
 
-void MatrixAnimation::onUpdate(Context c) {
+MatrixAnimation::~MatrixAnimation() {
+	if (system) {
+		system->remove(this);
+	}
 }
 
-void MatrixAnimation::onFixedUpdate(FixedContext c) {
-	old_percentage = percentage;
-	percentage += TICK_DURATION * animation_speed;
-	if (percentage > 1) percentage -= 1;
-	switch (type) {
-		case NONE:
-			break;
+void MatrixAnimation::setAnimation(const MatrixAnimation::AnimationType newType) {
+	switch (newType) {
 		case ROTATE:
-			rotation();
+			setClip(AnimationClip::rotation());
 			break;
 		case TRANSLATE:
-			translation();
-			break;
-		case SHAPE:
-			shape();
+			setClip(AnimationClip::translation());
 			break;
 		default:
+			setClip(nullptr);
 			break;
 	}
+
+	type = newType;
 }
 
-void MatrixAnimation::onConnected() {
+MatrixAnimation::AnimationType MatrixAnimation::getAnimation() const {
+	return type;
 }
 
-InputResult MatrixAnimation::onEvent(const InputEvent& event) {
-	return InputResult::PASS;
+void MatrixAnimation::setClip(const std::shared_ptr<const AnimationClip>& new_clip) {
+	clip = new_clip;
+	type = NONE;
+	time = 0;
+
+	if (system) {
+		system->refresh(this, true);
+	}
+}
+
+std::shared_ptr<const AnimationClip> MatrixAnimation::getClip() const {
+	return clip;
 }
 
-void MatrixAnimation::rotation() {
-	auto rotation = (float) (percentage * M_PI * 2);
-	setRotation(glm::rotate(glm::identity<glm::quat>(), rotation, glm::vec3(1, 1, 1)));
+void MatrixAnimation::setSpeed(float new_speed) {
+	speed = new_speed;
+
+	if (system) {
+		system->refresh(this, false);
+	}
 }
 
-void MatrixAnimation::translation() {
-	float v_1 = percentage > 0.5 ? 1 - percentage : percentage;
-	float v_2 = old_percentage > 0.5 ? 1 - old_percentage : old_percentage;
+float MatrixAnimation::getSpeed() const {
+	return speed;
+}
 
-	glm::vec3 position = glm::vec3(v_1, v_1, v_1) * -10.0f;
-	glm::vec3 old_position = glm::vec3(v_2, v_2, v_2) * -10.0f;
-	glm::vec3 posDiff = old_position - position;
-	setPosition(getPosition() + posDiff);
+float MatrixAnimation::getTime() const {
+	return system ? system->getTime(index) : time;
 }
 
-void MatrixAnimation::shape() {
+void MatrixAnimation::onUpdate(Context c) {
+}
+
+void MatrixAnimation::onFixedUpdate(FixedContext c) {
+}
+
+void MatrixAnimation::onConnected() {
+}
+
+InputResult MatrixAnimation::onEvent(const InputEvent& event) {
+	return InputResult::PASS;
 }
@@ -1,8 +1,15 @@
 #pragma once
 #include "game.hpp"
+#include "engine/animation.hpp"
 
 
+/**
+ * Plays an AnimationClip on the owning pawn, animations are not ticked one by one,
+ * all the animations of a board are sampled together by its AnimationSystem in the fixed update
+ */
 class MatrixAnimation : public GameComponent {
+	friend class AnimationSystem;
+
 public:
 	enum AnimationType {
 		NONE,
@@ -13,15 +20,15 @@ public:
 
 protected:
 	AnimationType type;
-	double animation_speed;
-	double percentage;
-	double old_percentage;
-
-	void rotation();
+	std::shared_ptr<const AnimationClip> clip;
+	float speed;
 
-	void translation();
+	///playback time, only up to date while the animation is not a part of a system, see getTime()
+	float time;
 
-	void shape();
+	///system that samples this animation and the position in its arrays
+	AnimationSystem* system;
+	uint32_t index;
 
 public:
 	MatrixAnimation() = delete;
@@ -30,10 +37,42 @@ public:
 
 	MatrixAnimation(SpatialPawn* s, AnimationType type);
 
+	MatrixAnimation(SpatialPawn* s, const std::shared_ptr<const AnimationClip>& clip);
+
+	~MatrixAnimation() override;
+
+	/**
+	 * selects one of the builtin clips, SHAPE and NONE play nothing
+	 */
 	void setAnimation(AnimationType newType);
 
+	/**
+	 * returns the builtin clip type, NONE if a custom clip is played
+	 */
 	AnimationType getAnimation() const;
 
+	/**
+	 * plays the given clip from the start, clips can be shared between any number of animations
+	 */
+	void setClip(const std::shared_ptr<const AnimationClip>& new_clip);
+
+	/**
+	 * returns the played clip, or nullptr if nothing is played
+	 */
+	std::shared_ptr<const AnimationClip> getClip() const;
+
+	/**
+	 * sets the playback speed multiplier, 1 by default
+	 */
+	void setSpeed(float new_speed);
+
+	float getSpeed() const;
+
+	/**
+	 * returns the playback time within the clip in seconds
+	 */
+	float getTime() const;
+
 	void onUpdate(Context c) override;
 
 	void onFixedUpdate(FixedContext c) override;
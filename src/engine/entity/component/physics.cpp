@@ -10,6 +10,7 @@ PhysicsComponent::PhysicsComponent(SpatialPawn* sp, Collider collider, bool is_s
 	this->mass = calculateMass();
 	this->initMass = true;
 	this->collider.setInertiaTensor(glm::mat3x3(mass));
+	this->ticking = TICK_FIXED_UPDATE;
 }
 
 PhysicsComponent::PhysicsComponent(SpatialPawn* sp): GameComponent(sp) {
@@ -20,6 +21,7 @@ PhysicsComponent::PhysicsComponent(SpatialPawn* sp): GameComponent(sp) {
 	this->mass = calculateMass();
 	this->initMass = true;
 	this->collider.setInertiaTensor(glm::mat3x3(mass));
+	this->ticking = TICK_FIXED_UPDATE;
 }
 
 
@@ -6,15 +6,38 @@
 
 
 RenderComponent::RenderComponent(SpatialPawn* sp, Models::Shape s) : GameComponent(sp) {
-	render_object = RenderSystem::system->createRenderObject();
-	render_object->setMatrix(glm::identity<glm::mat4x3>());
-	render_object->setModel(Models::getShape(s));
-	render_object->setActive(false);
+	shape = s;
 	rendering = false;
+
+	// without a renderer the component keeps no render object and skips all the render calls
+	if (Headless::hasRenderer()) {
+		binding = BackendBindings::bind([this] () {
+			bindRenderObject();
+		});
+	}
+
+	// the matrix is only synced when the pawn moves, see onTransformChanged()
+	ticking = TICK_NONE;
+}
+
+void RenderComponent::bindRenderObject() {
+	render_object = RenderSystem::system->createRenderObject();
+	render_object->setModel(Models::getShape(shape));
+
+	// the binding can be deferred past onConnected(), so sync the state it would have set
+	render_object->setMatrix(getSpatialParent()->getWorldMatrix());
+	render_object->setActive(rendering);
+}
+
+Models::Shape RenderComponent::getShape() const {
+	return shape;
+}
+
+bool RenderComponent::hasRenderObject() const {
+	return render_object != nullptr;
 }
 
 void RenderComponent::onUpdate(Context c) {
-	render_object->setMatrix(dynamic_cast<SpatialPawn *>(parent)->getMatrix()); //TODO if move byte
 }
 
 void RenderComponent::onFixedUpdate(FixedContext c) {
@@ -25,11 +48,24 @@ InputResult RenderComponent::onEvent(const InputEvent& event) {
 }
 
 void RenderComponent::onConnected() {
+	// the render object can still be missing (headless or deferred binding), the state is picked up by bindRenderObject()
+	if (render_object) {
+		render_object->setMatrix(getSpatialParent()->getWorldMatrix());
+	}
+
 	setRendering(true);
 }
 
+void RenderComponent::onTransformChanged() {
+	if (!render_object) {
+		return;
+	}
+
+	render_object->setMatrix(getSpatialParent()->getWorldMatrix());
+}
+
 void RenderComponent::setRendering(bool is_rendering) {
-	if (is_rendering != rendering) {
+	if (is_rendering != rendering && render_object) {
 		render_object->setActive(is_rendering);
 	}
 	rendering = is_rendering;
@@ -37,7 +73,10 @@ void RenderComponent::setRendering(bool is_rendering) {
 
 void RenderComponent::remove() {
 	GameComponent::remove();
-	render_object->setActive(false);
+
+	if (render_object) {
+		render_object->setActive(false);
+	}
 }
 
 RenderComponent::~RenderComponent() {
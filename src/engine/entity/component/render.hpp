@@ -2,16 +2,31 @@
 #include "game.hpp"
 #include "render/render.hpp"
 #include "engine/data/models.hpp"
+#include "engine/headless.hpp"
 
 class RenderComponent : public GameComponent {
 protected:
 	std::shared_ptr<RenderObject> render_object;
+	Models::Shape shape;
+
+	///pending creation of the render object, see BackendBindings
+	BackendBindings::Handle binding;
 
 public:
 	RenderComponent(SpatialPawn* sp, Models::Shape s);
 
 	~RenderComponent() override;
 
+	/**
+	 * returns the model this component renders
+	 */
+	Models::Shape getShape() const;
+
+	/**
+	 * returns false if the component was created without a renderer, see Headless
+	 */
+	bool hasRenderObject() const;
+
 protected:
 	bool rendering;
 
@@ -21,9 +36,16 @@ protected:
 
 	void onConnected() override;
 
+	void onTransformChanged() override;
+
 	InputResult onEvent(const InputEvent& event) override;
 
 	void setRendering(bool is_rendering);
 
+	/**
+	 * creates the render object, runs on the main thread, see BackendBindings
+	 */
+	void bindRenderObject();
+
 	void remove() override;
 };
@@ -1,24 +1,48 @@
 #include "sound.hpp"
 
-SoundComponent::SoundComponent(SpatialPawn* t,const std::string& path) : GameComponent(t) {
+SoundComponent::SoundComponent(SpatialPawn* t,const std::string& path) : GameComponent(t), path(path) {
+	// the source is only synced when the pawn moves, see onTransformChanged()
+	ticking = TICK_UPDATE;
+
+	// headless components keep no source, and don't need to tick at all
+	if (Headless::isEnabled()) {
+		ticking = TICK_NONE;
+		return;
+	}
+
+	binding = BackendBindings::bind([this] () {
+		bindSource();
+	});
+}
+
+void SoundComponent::bindSource() {
 	SoundManager& sound_manager = SoundManager::getInstance();
 
 	sound_source_object = std::make_shared<SoundSourceObject>();
 	sound_manager.addSource(sound_source_object);
 	sound_manager.createSoundClipAndAddToSourceObject(path.c_str(), sound_source_object);
 	//sound_source_object->setReferenceDistance(10.f);
+
+	// the binding can be deferred past onConnected(), so sync the position it would have set
+	onTransformChanged();
 }
 
 SoundComponent::~SoundComponent() {
 }
 
+const std::string& SoundComponent::getPath() const {
+	return path;
+}
+
 void SoundComponent::onUpdate(Context c) {
+	if (!sound_source_object) {
+		return;
+	}
+
 	SoundManager::getInstance().playSound(sound_source_object);
 }
 
 void SoundComponent::onFixedUpdate(FixedContext c) {
-	sound_source_object->setPosition(getPosition());
-	sound_source_object->setVelocity(getVelocity());
 }
 
 InputResult SoundComponent::onEvent(const InputEvent& event) {
@@ -26,11 +50,20 @@ InputResult SoundComponent::onEvent(const InputEvent& event) {
 }
 
 void SoundComponent::onConnected() {
+	onTransformChanged();
+}
+
+void SoundComponent::onTransformChanged() {
+	if (!sound_source_object) {
+		return;
+	}
 
+	sound_source_object->setPosition(getSpatialParent()->getWorldPosition());
+	sound_source_object->setVelocity(getVelocity());
 }
 
 void SoundComponent::debugDraw(ImmediateRenderer& renderer) {
-	const glm::vec3 position = getPosition();
+	const glm::vec3 position = getSpatialParent()->getWorldPosition();
 	renderer.setBillboardMode(BillboardMode::TWO_AXIS);
 	renderer.setSprite(default_file_name);
 	renderer.drawRect3D(position.x,position.y,position.z,1.0f,1.0f);
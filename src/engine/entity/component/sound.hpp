@@ -1,13 +1,17 @@
 #pragma once
 #include "game.hpp"
 #include "sound/sound.hpp"
+#include "engine/headless.hpp"
 
 
 class SoundComponent : public GameComponent {
-
 	static inline std::string default_file_name = "assets/image/speaker.png";
 
 	std::shared_ptr<SoundSourceObject> sound_source_object;
+	std::string path;
+
+	///pending creation of the sound source, see BackendBindings
+	BackendBindings::Handle binding;
 public:
 
 
@@ -15,6 +19,11 @@ public:
 
 	~SoundComponent() override;
 
+	/**
+	 * returns the path of the sound clip played by this component
+	 */
+	const std::string& getPath() const;
+
 protected:
 	void onUpdate(Context c) override;
 
@@ -24,6 +33,13 @@ protected:
 
 	void onConnected() override;
 
+	void onTransformChanged() override;
+
+	/**
+	 * creates the sound source, runs on the main thread, see BackendBindings
+	 */
+	void bindSource();
+
 public:
 	void debugDraw(ImmediateRenderer& renderer) override;
 };
@@ -5,7 +5,7 @@
  */
 
 
-Context::Context(const float delta, const std::shared_ptr<Pawn>& pawn) {
+Context::Context(const float delta, Pawn* pawn) {
 	parent_pawn = pawn;
 	deltaTime = delta;
 }
@@ -3,11 +3,11 @@
 
 struct Context {
 	double deltaTime;
-	std::shared_ptr<Pawn> parent_pawn;
+	Pawn* parent_pawn;
 
-	Context(float delta, const std::shared_ptr<Pawn>& pawn);
+	Context(float delta, Pawn* pawn);
 };
 
 struct FixedContext {
-	std::shared_ptr<Pawn> parent_pawn;
+	Pawn* parent_pawn;
 };
@@ -6,7 +6,7 @@ class Entity {
 protected:
 	bool active;
 	bool to_remove;
-	inline static uint32_t id_number = 0;
+	inline static std::atomic<uint32_t> id_number = 0;
 	inline static std::string class_name = "base entity";
 	uint32_t id;
 
@@ -6,6 +6,7 @@
 #include "../board.hpp"
 #include "shared/logger.hpp"
 #include "component/physics.hpp"
+#include "../storage.hpp"
 
 
 /*
@@ -205,18 +206,11 @@ bool PawnState::convert(Pawn* new_child, Pawn* new_parent) {
  */
 
 void Pawn::onUpdate(double delta) {
-	std::shared_ptr<Pawn> p = shared_from_this();
-	Context cntx(delta, p);
-	for (const std::shared_ptr<Component>& c: components) {
-		c->onUpdate(cntx);
-	}
+	//components are ticked by the PawnTree tick lists
 }
 
 void Pawn::onFixedUpdate() {
-	FixedContext cntx;
-	for (const std::shared_ptr<Component>& c: components) {
-		c->onFixedUpdate(cntx);
-	}
+	//components are ticked by the PawnTree tick lists
 }
 
 Pawn::Pawn() : Entity() {
@@ -226,14 +220,37 @@ Pawn::Pawn() : Entity() {
 	board = nullptr;
 	pawn_state = PawnState::NEW;
 	is_tracked_on_hash = false;
+	thread_safe = false;
+	child_index = 0;
+	name_index = 0;
+	update_priority = UpdatePriority::NORMAL;
+	pending_delta = 0;
+	update_delta = 0;
+	update_due = true;
+	update_overdue = false;
 }
 
 Pawn::Pawn(const std::string& s) : Pawn() {
-	name = s;
+	name = Atom::of(s);
 }
 
-std::shared_ptr<Component>& Pawn::addComponent(std::shared_ptr<Component> c) {
+Pawn::~Pawn() {
+	for (const std::shared_ptr<Component>& c: components) {
+		ComponentArray::removeFromAll(c.get());
+	}
+}
+
+std::shared_ptr<Component>& Pawn::addComponent(std::shared_ptr<Component> c, uint32_t type_id) {
 	c->parent = this;
+	c->type_id = type_id;
+
+	// only the first component of each class is indexed
+	if (const uint64_t bit = ComponentSignature::bit(type_id); bit != 0 && !(signature.mask & bit)) {
+		const size_t rank = std::popcount(signature.mask & (bit - 1));
+		indexed_components.insert(indexed_components.begin() + rank, c.get());
+		signature.mask |= bit;
+	}
+
 	c->onConnected();
 	if (auto const pc = std::dynamic_pointer_cast<PhysicsComponent>(c)) {
 		physics_component = pc;
@@ -241,6 +258,9 @@ std::shared_ptr<Component>& Pawn::addComponent(std::shared_ptr<Component> c) {
 			board->registerPhysicsComponent(pc);
 		}
 	}
+	if (isRooted()) {
+		root_pawn.lock()->getTree()->registerComponent(c.get());
+	}
 	return components.emplace_back(c);
 }
 
@@ -254,6 +274,46 @@ void Pawn::propagateRemove() {
 	}
 }
 
+void Pawn::detachChild(Pawn* child) {
+	size_t index = child->child_index;
+
+	// the index can be stale if the list was modified through getChildren()
+	if (index >= children.size() || children[index].get() != child) {
+		auto it = std::find_if(children.begin(), children.end(), [child] (const std::shared_ptr<Pawn>& c) {
+			return c.get() == child;
+		});
+
+		if (it == children.end()) {
+			return;
+		}
+
+		index = it - children.begin();
+	}
+
+	if (index != children.size() - 1) {
+		children[index] = std::move(children.back());
+		children[index]->child_index = index;
+	}
+
+	children.pop_back();
+}
+
+PawnHandle Pawn::getHandle() const {
+	return handle;
+}
+
+void Pawn::receive(std::span<Message* const> messages) {
+	for (const Message* message : messages) {
+
+		// handlers can register more listeners, so don't use iterators here
+		for (size_t i = 0; i < listeners.size(); i ++) {
+			if (listeners[i].first == message->getType()) {
+				listeners[i].second(*message);
+			}
+		}
+	}
+}
+
 bool Pawn::isRooted() {
 	if (!root_pawn.expired()) {
 		return true;
@@ -293,6 +353,7 @@ std::vector<std::shared_ptr<Pawn>>& Pawn::getChildren() {
 
 void Pawn::addChild(const std::shared_ptr<Pawn>& new_child) {
 	new_child->parent = shared_from_this();
+	new_child->child_index = children.size();
 	//converts state of child and this pawn based on their previous state
 	PawnState::convert(new_child.get(), this);
 
@@ -315,11 +376,38 @@ void Pawn::addChild(const std::shared_ptr<Pawn>& new_child) {
 	}
 }
 
-std::string Pawn::getName() {
+const std::string& Pawn::getName() const {
+	return name.str();
+}
+
+Atom Pawn::getNameAtom() const {
 	return name;
 }
 
-void Pawn::setName(std::string new_name) {
+void Pawn::setName(const std::string& new_name) {
+	setName(Atom::of(new_name));
+}
+
+void Pawn::setName(const Atom new_name) {
+	if (name == new_name) {
+		return;
+	}
+
+	// move the pawn to the bucket of its new name
+	if (is_tracked_on_hash && isRooted()) {
+		PawnTree* tree = root_pawn.lock()->getTree();
+
+		// renames made during a parallel update take effect after it, see PawnTree::deferChange()
+		if (tree->deferChange([self = shared_from_this(), new_name] () { self->setName(new_name); })) {
+			return;
+		}
+
+		tree->removeFromMaps(this);
+		name = new_name;
+		tree->addPawnToHash(name, id, shared_from_this());
+		return;
+	}
+
 	name = new_name;
 }
 
@@ -335,8 +423,45 @@ bool Pawn::isMountedToBoard() const {
 	return is_mounted_to_board;
 }
 
+void Pawn::setThreadSafe(const bool value) {
+	if (thread_safe == value) {
+		return;
+	}
+
+	thread_safe = value;
+
+	//components of thread-safe subtrees are kept in a separate tick list
+	if (isRooted()) {
+		root_pawn.lock()->getTree()->registerComponentsRecursion(shared_from_this());
+	}
+}
+
+bool Pawn::isThreadSafe() const {
+	return thread_safe;
+}
+
+bool Pawn::getSchedulingPosition(glm::vec3& position) const {
+	return false;
+}
+
+void Pawn::setUpdatePriority(const UpdatePriority priority) {
+	update_priority = priority;
+}
+
+UpdatePriority Pawn::getUpdatePriority() const {
+	return update_priority;
+}
+
+bool Pawn::isUpdateDue() const {
+	return update_due;
+}
+
+double Pawn::getUpdateDelta() const {
+	return update_delta;
+}
+
 std::string Pawn::toString() const {
-	if (name != "") return name;
+	if (!name.empty()) return name.str();
 	else return "Unnamed Pawn";
 }
 
@@ -411,6 +536,10 @@ std::vector<std::shared_ptr<Component>>& Pawn::getComponents() {
 	return components;
 }
 
+ComponentSignature Pawn::getSignature() const {
+	return signature;
+}
+
 void Pawn::debugDraw(ImmediateRenderer& renderer) {
 	for (std::shared_ptr<Pawn>& p : children) {
 		p->debugDraw(renderer);
@@ -426,7 +555,7 @@ bool Pawn::safeRemove() {
 		FAULT("This shouldn't be root as its as this function should only be called for children of removed pawn");
 	}
 #endif
-	if (to_remove) {
+	if (!to_remove) {
 #if ENGINE_DEBUG
 		if (pawn_state == PawnState::REMOVED)
 			FAULT("Pawn state is REMOVED before using remove() function on it");
@@ -435,8 +564,13 @@ bool Pawn::safeRemove() {
 
 		propagateRemove();
 
-		board->queueRemove(shared_from_this());
+		pawn_state = PawnState::REMOVED;
+
+		for (const std::shared_ptr<Component>& c: components) {
+			c->remove();
+		}
 
+		// the whole subtree is released together with the removed parent, see Board::dequeueRemove()
 		return true;
 	} else {
 		out::warn("While removing children of an object Engine tried to remove() the same pawn more than once!");
@@ -4,12 +4,19 @@
 #include "input/input.hpp"
 #include "context.hpp"
 #include "../trait.hpp"
+#include "shared/slab.hpp"
+#include "shared/atom.hpp"
+#include "shared/thread/bus.hpp"
+#include "../scheduler.hpp"
 
 class PhysicsComponent;
 
 class PawnTree;
 class Board;
 class RootPawn;
+class Pawn;
+
+using PawnHandle = Handle<Pawn*>;
 
 namespace PawnState {
 	enum State {
@@ -34,19 +41,29 @@ namespace PawnState {
 }
 
 /**
- * Enables the component to bind to this enclosing pawn
+ * Enables the component to bind to this enclosing pawn, components are allocated from per-type slab pools
  */
-#define COMPONENT_BIND_POINT template<DerivedTrait<Component> T, typename... Args> std::shared_ptr<T> createComponent(Args... args) { return static_pointer_cast<T>(addComponent(std::make_shared<T>(this, args...))); }
+#define COMPONENT_BIND_POINT template<DerivedTrait<Component> T, typename... Args> std::shared_ptr<T> createComponent(Args... args) { return static_pointer_cast<T>(addComponent(std::allocate_shared<T>(SlabAllocator<T> {}, this, args...), ComponentTypeId::of<T>())); }
 
 class Pawn : public Entity, public std::enable_shared_from_this<Pawn> {
 protected:
 	friend class PawnTree;
 	friend class Board;
+	friend class UpdateScheduler;
 
 	friend bool PawnState::convert(Pawn* new_child, Pawn* new_parent);
 
-	std::vector<std::shared_ptr<Pawn>> children; //TODO updating this to make sure its up to date when removing children
+	std::vector<std::shared_ptr<Pawn>> children;
 	std::weak_ptr<Pawn> parent;
+
+	///generational handle of this pawn, assigned when the pawn becomes a part of a board
+	PawnHandle handle;
+
+	///position of this pawn in the children list of its parent
+	size_t child_index;
+
+	///position of this pawn in the name bucket of a PawnTree
+	size_t name_index;
 	bool to_remove;
 	PawnState::State pawn_state;
 
@@ -58,13 +75,30 @@ protected:
 	///checks if the pawn is saved to hashmap
 	bool is_tracked_on_hash;
 
+	///checks if the pawn and its subtree can be updated concurrently with other thread-safe subtrees
+	bool thread_safe;
+
+	///update scheduling state, see UpdateScheduler
+	UpdatePriority update_priority;
+	double pending_delta;
+	double update_delta;
+	bool update_due;
+	bool update_overdue;
+
 	Board* board;
-	std::string name;
+	Atom name;
 	std::weak_ptr<RootPawn> root_pawn;
 
 	std::vector<std::shared_ptr<Component>> components; //TODO unique ptr ???
 	std::weak_ptr<PhysicsComponent> physics_component;
 
+	///classes of the components of this pawn, and the first component of each indexed class, ordered by class id
+	ComponentSignature signature;
+	std::vector<Component*> indexed_components;
+
+	///message handlers of this pawn, see listen()
+	std::vector<std::pair<const MessageType*, std::function<void(const Message&)>>> listeners;
+
 	/**
 	 * All the things that happens on basic update of the engine (intervals between basic updates can vary)
 	 */
@@ -77,11 +111,22 @@ protected:
 
 	void setBoard(Board* s);
 
+	/**
+	 * Returns the position used to pick the update tier of this pawn, pawns without a position
+	 * return false and are always updated unless they have low priority
+	 */
+	virtual bool getSchedulingPosition(glm::vec3& position) const;
+
 	/**
 	 * Removes all the children of a pawn
 	 */
 	void propagateRemove();
 
+	/**
+	 * Removes a child from the children list in O(1), the last child takes its place
+	 */
+	void detachChild(Pawn* child);
+
 	/**
 	 * Similar to remove function, but there is no need to check if the pawn is root
 	 */
@@ -95,19 +140,44 @@ protected:
 
 	void removeComponents();
 
+	/**
+	 * Passes the delivered messages to the listeners registered for their types
+	 */
+	void receive(std::span<Message* const> messages);
+
 public:
 	Pawn();
 
 	Pawn(const std::string& s);
 
+	~Pawn() override;
+
 	/**
-	 * Adds a new component to a pawn
+	 * Adds a new component to a pawn, components created with createComponent() also pass the id of their class,
+	 * so that they can be found with getComponent()
 	 */
 	//todo fix
-	std::shared_ptr<Component>& addComponent(std::shared_ptr<Component> c);
+	std::shared_ptr<Component>& addComponent(std::shared_ptr<Component> c, uint32_t type_id = ComponentTypeId::INVALID);
 
 	COMPONENT_BIND_POINT
 
+	/**
+	 * Returns a stable handle to this pawn that can be resolved with Board::getPawn(), the handle
+	 * expires when the pawn is removed from the board, empty if the pawn was never a part of one
+	 */
+	PawnHandle getHandle() const;
+
+	/**
+	 * Registers a handler for messages of the given type posted to this pawn with Board::post(),
+	 * handlers are called on the main thread at the phase boundaries of the frame, see Board::deliverMessages()
+	 */
+	template <typename T>
+	void listen(const std::function<void(const T&)>& handler) {
+		listeners.emplace_back(MessageType::of<T>(), [handler] (const Message& message) {
+			handler(message.as<T>());
+		});
+	}
+
 	/**
 	 * Checks if a pawn belongs to a Scene (contains a RootPawn in its parent chain)
 	 */
@@ -141,12 +211,22 @@ public:
 	/**
 	 * Returns a name that is specific to that instance of a pawn
 	 */
-	std::string getName();
+	const std::string& getName() const;
+
+	/**
+	 * Returns the interned name of this instance of a pawn, see PawnTree::findByName(Atom)
+	 */
+	Atom getNameAtom() const;
+
+	/**
+	 * Sets name of this instance of a pawn
+	 */
+	void setName(const std::string& new_name);
 
 	/**
 	 * Sets name of this instance of a pawn
 	 */
-	void setName(std::string new_name);
+	void setName(Atom new_name);
 
 
 	/**
@@ -169,6 +249,39 @@ public:
 	 */
 	bool isMountedToBoard() const;
 
+	/**
+	 * marks the pawn and its whole subtree as safe to update on a worker thread, concurrently with other
+	 * thread-safe subtrees (its onUpdate can't touch pawns outside of its own subtree), only used if the board has parallel update enabled,
+	 * the subtree can still add children and components, rename and remove its pawns, but the board only sees these changes
+	 * (lookups by name or id, handles, ticking of new components) after all the thread-safe subtrees were updated
+	 */
+	void setThreadSafe(bool value);
+
+	/**
+	 * returns true if the pawn subtree can be updated concurrently with other thread-safe subtrees
+	 */
+	bool isThreadSafe() const;
+
+	/**
+	 * sets the update priority hint used by the board update scheduler
+	 */
+	void setUpdatePriority(UpdatePriority priority);
+
+	/**
+	 * returns the update priority hint of this pawn
+	 */
+	UpdatePriority getUpdatePriority() const;
+
+	/**
+	 * returns true if the pawn (and so its components) is updated in the current frame
+	 */
+	bool isUpdateDue() const;
+
+	/**
+	 * returns the time since the previous update of this pawn, in seconds, it can span multiple frames
+	 */
+	double getUpdateDelta() const;
+
 	/**
 	 * returns small amount of information about the pawn ina a string format, currently only a name [for full description use toStringVerbose]
 	 */
@@ -196,5 +309,50 @@ public:
 
 	std::vector<std::shared_ptr<Component>>& getComponents();
 
+	/**
+	 * Returns the first component created as exactly the class T (subclasses are not matched), or nullptr if
+	 * there is none, the lookup is a bit test and a popcount, so it's cheap enough to be done every frame
+	 */
+	template<DerivedTrait<Component> T>
+	T* getComponent() const {
+		const uint32_t id = ComponentTypeId::of<T>();
+		const uint64_t bit = ComponentSignature::bit(id);
+
+		if (bit != 0) {
+			return (signature.mask & bit) ? static_cast<T*>(indexed_components[std::popcount(signature.mask & (bit - 1))]) : nullptr;
+		}
+
+		// classes past the signature size are not indexed
+		for (const std::shared_ptr<Component>& component : components) {
+			if (component->getTypeId() == id) {
+				return static_cast<T*>(component.get());
+			}
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * Returns the set of component classes of this pawn
+	 */
+	ComponentSignature getSignature() const;
+
+	/**
+	 * Checks if the pawn has components of all the given classes
+	 */
+	template<DerivedTrait<Component>... T>
+	bool hasComponents() const {
+		return signature.contains(ComponentSignature::of<T...>());
+	}
+
 	void debugDraw(ImmediateRenderer& renderer) override;
 };
+
+/**
+ * Creates a new pawn of the given type, pawns are allocated from per-type slab pools so spawning
+ * and despawning many pawns doesn't hit the system allocator, see SlabPool::getAllStatistics()
+ */
+template<DerivedTrait<Pawn> T, typename... Args>
+std::shared_ptr<T> makePawn(Args&&... args) {
+	return std::allocate_shared<T>(SlabAllocator<T> {}, std::forward<Args>(args)...);
+}
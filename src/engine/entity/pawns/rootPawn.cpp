@@ -10,7 +10,7 @@ void RootPawn::setTree(PawnTree* tree) {
 }
 
 RootPawn::RootPawn() : Pawn() {
-	name = "Root";
+	name = Atom::of("Root");
 	tr = nullptr;
 }
 
@@ -1,4 +1,6 @@
 #include "spatialPawn.hpp"
+#include "rootPawn.hpp"
+#include "../../pawnTree.hpp"
 
 /*
  * SpatialPawn
@@ -10,14 +12,33 @@ SpatialPawn::SpatialPawn() : Pawn() {
 	velocity = {0, 0, 0};
 	angular_velocity = {0, 0, 0};
 	scale = {1, 1, 1};
+	affineTransformMatrix = glm::mat4x3(1.0f);
+	transform_dirty = false;
+	transform_epoch = 0;
+	spatial_cell = 0;
+	spatial_slot = 0;
+	spatial_indexed = false;
+}
+
+void SpatialPawn::markTransformDirty() {
+	if (transform_dirty || !isRooted()) {
+		return;
+	}
+
+	transform_dirty = true;
+	root_pawn.lock()->getTree()->queueTransform(this);
 }
 
 void SpatialPawn::addPosition(const glm::vec3 new_position) {
 	position = position + new_position;
+	markTransformDirty();
 }
 
 void SpatialPawn::setPosition(const glm::vec3 new_position) {
-	position = new_position;
+	if (position != new_position) {
+		position = new_position;
+		markTransformDirty();
+	}
 }
 
 glm::vec3 SpatialPawn::getPosition() const {
@@ -41,7 +62,10 @@ glm::vec3 SpatialPawn::getAngularVelocity() {
 }
 
 void SpatialPawn::setRotation(const glm::quat new_rotation) {
-	rotation = new_rotation;
+	if (rotation != new_rotation) {
+		rotation = new_rotation;
+		markTransformDirty();
+	}
 }
 
 glm::quat SpatialPawn::getRotation() const {
@@ -49,20 +73,54 @@ glm::quat SpatialPawn::getRotation() const {
 }
 
 void SpatialPawn::setScale(const glm::vec3 new_scale) {
-	scale = new_scale;
+	if (scale != new_scale) {
+		scale = new_scale;
+		markTransformDirty();
+	}
 }
 
 glm::vec3 SpatialPawn::getScale() const {
 	return scale;
 }
 
-glm::mat4x3 SpatialPawn::getMatrix() const {
+glm::mat4 SpatialPawn::getLocalMatrix() const {
 	const glm::mat4 translation = glm::translate(glm::mat4(1.0f), position);
 	const glm::mat4 rotMatrix = glm::toMat4(rotation);
 	const glm::mat4 scaleMatrix = glm::scale(glm::mat4(1.0f), scale);
 
-	const glm::mat4 affineMatrix = translation * rotMatrix * scaleMatrix;
-	return glm::mat4x3(affineMatrix);
+	return translation * rotMatrix * scaleMatrix;
+}
+
+glm::mat4 SpatialPawn::getParentWorldMatrix() const {
+	std::shared_ptr<Pawn> recursive_parent = parent.lock();
+
+	// non-spatial pawns in between are transparent to the transform
+	while (recursive_parent) {
+		if (const auto* spatial = dynamic_cast<SpatialPawn*>(recursive_parent.get())) {
+			return glm::mat4(spatial->affineTransformMatrix);
+		}
+
+		recursive_parent = recursive_parent->getParent();
+	}
+
+	return glm::mat4(1.0f);
+}
+
+glm::mat4x3 SpatialPawn::getMatrix() const {
+	return glm::mat4x3(getLocalMatrix());
+}
+
+glm::mat4x3 SpatialPawn::getWorldMatrix() const {
+	return affineTransformMatrix;
+}
+
+glm::vec3 SpatialPawn::getWorldPosition() const {
+	return affineTransformMatrix[3];
+}
+
+bool SpatialPawn::getSchedulingPosition(glm::vec3& position) const {
+	position = getWorldPosition();
+	return true;
 }
 
 glm::vec3 SpatialPawn::getForwardVector() const {
@@ -4,6 +4,9 @@
 
 class SpatialPawn : public Pawn {
 protected:
+	friend class PawnTree;
+	friend class SpatialIndex;
+
 	glm::vec3 velocity;
 	glm::vec3 angular_velocity;
 
@@ -11,8 +14,37 @@ protected:
 	glm::quat rotation;
 	glm::vec3 scale;
 
+	///cached world transform, recomputed by the PawnTree only when this pawn or one of its parents moved
 	glm::mat4x3 affineTransformMatrix;
 
+	///true if the pawn is waiting in the PawnTree for its world transform to be recomputed
+	bool transform_dirty;
+
+	///last PawnTree transform flush in which the world transform of this pawn changed
+	uint32_t transform_epoch;
+
+	///position of this pawn in the SpatialIndex of its board
+	uint64_t spatial_cell;
+	size_t spatial_slot;
+	bool spatial_indexed;
+
+	/**
+	 * Queues the world transform of this pawn and its children to be recomputed, does nothing until the pawn is a part of a board
+	 */
+	void markTransformDirty();
+
+	/**
+	 * Returns affine transform matrix relative to the parent as a 4x4 matrix
+	 */
+	glm::mat4 getLocalMatrix() const;
+
+	/**
+	 * Returns world transform of the closest SpatialPawn parent, or identity if there is none
+	 */
+	glm::mat4 getParentWorldMatrix() const;
+
+	bool getSchedulingPosition(glm::vec3& position) const override;
+
 public:
 	SpatialPawn();
 
@@ -24,12 +56,12 @@ public:
 	void addPosition(glm::vec3 new_position);
 
 	/**
-	 * Sets absolute position of a pawn in 3D space
+	 * Sets position of a pawn in 3D space, relative to its parent
 	 */
 	void setPosition(glm::vec3 new_position);
 
 	/**
-	 * Returns absolute position of a pawn in 3D space
+	 * Returns position of a pawn in 3D space, relative to its parent
 	 */
 	glm::vec3 getPosition() const;
 
@@ -54,30 +86,41 @@ public:
 	glm::vec3 getAngularVelocity();
 
 	/**
-	 * Sets absolute rotation of a pawn in 3D space
+	 * Sets rotation of a pawn in 3D space, relative to its parent
 	 */
 	void setRotation(glm::quat new_rotation);
 
 	/**
-	 * Returns absolute rotation of a pawn in 3D space
+	 * Returns rotation of a pawn in 3D space, relative to its parent
 	 */
 	glm::quat getRotation() const;
 
 	/**
-	 * Sets absolute scale of a pawn in 3D space
+	 * Sets scale of a pawn in 3D space, relative to its parent
 	 */
 	void setScale(glm::vec3 new_scale);
 
 	/**
-	 * Sets absolute scale of a pawn in 3D space
+	 * Returns scale of a pawn in 3D space, relative to its parent
 	 */
 	glm::vec3 getScale() const;
 
 	/**
-	 * Returns affine transform matrix of an object. (Its rotation scale and position combined!)
+	 * Returns affine transform matrix of an object relative to its parent. (Its rotation scale and position combined!)
 	 */
 	glm::mat4x3 getMatrix() const;
 
+	/**
+	 * Returns affine transform matrix of an object in the world space, the value is cached and
+	 * refreshed by the board after the update and fixed update phases
+	 */
+	glm::mat4x3 getWorldMatrix() const;
+
+	/**
+	 * Returns position of a pawn in the world space, see getWorldMatrix()
+	 */
+	glm::vec3 getWorldPosition() const;
+
 	/**
 	 * Returns facing direction
 	 */
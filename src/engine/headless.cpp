@@ -0,0 +1,62 @@
+#include "headless.hpp"
+#include "render/system.hpp"
+
+/*
+ * Headless
+ */
+
+void Headless::setEnabled(bool headless) {
+	enabled = headless;
+}
+
+bool Headless::isEnabled() {
+	return enabled;
+}
+
+bool Headless::hasRenderer() {
+	if (enabled || !RenderSystem::system) {
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * BackendBindings
+ */
+
+BackendBindings::Scope::Scope(BackendBindings& bindings) {
+	previous = active;
+	active = &bindings;
+}
+
+BackendBindings::Scope::~Scope() {
+	active = previous;
+}
+
+BackendBindings::Handle BackendBindings::bind(std::function<void()> binding) {
+	if (active) {
+		Handle handle = std::make_shared<std::function<void()>>(std::move(binding));
+		active->bindings.push_back(handle);
+		return handle;
+	}
+
+	binding();
+	return nullptr;
+}
+
+void BackendBindings::apply() {
+	for (std::weak_ptr<std::function<void()>>& binding : bindings) {
+
+		// the owner could have been destroyed by the builder, for example after a failed load
+		if (Handle handle = binding.lock()) {
+			(*handle)();
+		}
+	}
+
+	bindings.clear();
+}
+
+size_t BackendBindings::size() const {
+	return bindings.size();
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "external.hpp"
+
+/**
+ * Runtime switch for running boards without a window, a Vulkan device or an audio device (dedicated simulation
+ * nodes, CPU benchmarks), in headless mode render and sound components bind to no backend objects and their calls become no-ops
+ */
+class Headless {
+	inline static std::atomic<bool> enabled = false;
+
+public:
+	/**
+	 * enables or disables headless mode, needs to be set before any board or component is created
+	 */
+	static void setEnabled(bool headless);
+
+	/**
+	 * returns true if headless mode was enabled
+	 */
+	static bool isEnabled();
+
+	/**
+	 * returns true if render components can create render objects, that is headless mode is disabled and
+	 * the RenderSystem was initialized, render components created otherwise skip all rendering
+	 */
+	static bool hasRenderer();
+};
+
+/**
+ * Collects the render and sound bindings of components that are created on a thread while a Scope is active, so that
+ * boards can be built on a worker thread (the backends are not thread-safe) and bound on the main thread later,
+ * see BoardManager::prepareBoard()
+ */
+class BackendBindings {
+	inline static thread_local BackendBindings* active = nullptr;
+
+	std::vector<std::weak_ptr<std::function<void()>>> bindings;
+
+public:
+	/**
+	 * owns a deferred binding, a binding whose handle was destroyed before apply() is dropped
+	 */
+	using Handle = std::shared_ptr<std::function<void()>>;
+
+	/**
+	 * defers the bindings of the calling thread into the given collection while it exists
+	 */
+	class Scope {
+		BackendBindings* previous;
+
+	public:
+		Scope(BackendBindings& bindings);
+		Scope(const Scope& other) = delete;
+		~Scope();
+	};
+
+	/**
+	 * runs the binding right away, or defers it if a Scope is active on the calling thread, the owner of the binding
+	 * (usually the component that queued it) needs to keep the returned handle, so that the binding is dropped together
+	 * with it, the handle is empty if the binding already ran
+	 */
+	[[nodiscard]] static Handle bind(std::function<void()> binding);
+
+	/**
+	 * runs all the deferred bindings that are still owned, must be called on the main thread
+	 */
+	void apply();
+
+	/**
+	 * returns the number of deferred bindings, including the ones whose owners were already destroyed
+	 */
+	size_t size() const;
+};
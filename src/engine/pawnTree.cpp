@@ -1,5 +1,6 @@
 #include "pawnTree.hpp"
 #include "shared/logger.hpp"
+#include "shared/arena.hpp"
 
 /*
  * PawnTree
@@ -10,68 +11,94 @@ PawnTree::PawnTree() {
 	//TODO adding root to hashmap (?)
 	root->pawn_state = PawnState::TRACKED;
 	root->tr = this;
+	transform_epoch = 0;
+	parallel_phase = false;
 }
 
 std::shared_ptr<Pawn> PawnTree::findByName(const std::string& name) {
-	std::unordered_multimap<std::string, std::shared_ptr<Pawn>>::iterator result = name_map.find(name);
-	if (result != name_map.end()) {
-		return result->second;
+
+	// a name that was never interned can't belong to any pawn
+	if (std::optional<Atom> atom = Atom::find(name)) {
+		return findByName(*atom);
+	}
+	return nullptr;
+}
+
+std::shared_ptr<Pawn> PawnTree::findByName(const Atom name) {
+	if (const std::vector<std::shared_ptr<Pawn>>* named = name_map.find(name)) {
+		return named->front();
 	}
 	return nullptr;
 }
 
 std::shared_ptr<Pawn> PawnTree::findByID(uint32_t id) {
-	std::unordered_multimap<uint32_t, std::shared_ptr<Pawn>>::iterator result = id_map.find(id);
+	auto result = id_map.find(id);
 	if (result != id_map.end()) {
 		return result->second;
 	}
 	return nullptr;
 }
 
-bool PawnTree::removeFromMaps(const std::string& name, uint32_t id) {
-	int erasedAmount = 0;
+bool PawnTree::removeFromMaps(Pawn* pawn) {
+	std::vector<std::shared_ptr<Pawn>>* bucket = name_map.find(pawn->name);
+	const size_t index = pawn->name_index;
 
-	auto results = name_map.equal_range(name);
+	if (bucket == nullptr || index >= bucket->size() || (*bucket)[index].get() != pawn) {
+		FAULT("There should be only one entity with given name and ID");
+	}
 
-	for (auto it = results.first; it != results.second;) {
-		if (it->second->id == id) {
-			it = name_map.erase(it);
-			erasedAmount++;
-			continue;
-		}
-		++it;
+	std::vector<std::shared_ptr<Pawn>>& named = *bucket;
+
+	// swap-remove, the last pawn with the same name takes the place of the removed one
+	if (index != named.size() - 1) {
+		named[index] = std::move(named.back());
+		named[index]->name_index = index;
 	}
 
-	if (erasedAmount == 1) {
-	} else {
-		FAULT("There should be only one entity with given name and ID");
+	named.pop_back();
+
+	if (named.empty()) {
+		name_map.erase(pawn->name);
 	}
 
-	id_map.erase(id_map.find(id));
+	id_map.erase(pawn->id);
+	pawn->setTracked(false);
 
 	return true;
 }
 
 std::vector<std::shared_ptr<Pawn>> PawnTree::findAllByName(const std::string& name) {
-	std::vector<std::shared_ptr<Pawn>> result;
-	auto range = name_map.equal_range(name);
-	for (auto r = range.first; r != range.second; ++r) {
-		result.push_back(r->second);
+	if (std::optional<Atom> atom = Atom::find(name)) {
+		return findAllByName(*atom);
 	}
-	return result;
+	return {};
+}
+
+std::vector<std::shared_ptr<Pawn>> PawnTree::findAllByName(const Atom name) {
+	if (const std::vector<std::shared_ptr<Pawn>>* named = name_map.find(name)) {
+		return *named;
+	}
+	return {};
 }
 
 std::vector<std::shared_ptr<Pawn>> PawnTree::findAllByID(const uint32_t id) {
 	std::vector<std::shared_ptr<Pawn>> result;
-	auto range = id_map.equal_range(id);
-	for (auto r = range.first; r != range.second; ++r) {
-		result.push_back(r->second);
+	if (std::shared_ptr<Pawn> pawn = findByID(id)) {
+		result.push_back(pawn);
 	}
 	return result;
 }
 
 size_t PawnTree::nameHitSize(const std::string& name) const {
-	return name_map.count(name);
+	if (std::optional<Atom> atom = Atom::find(name)) {
+		return nameHitSize(*atom);
+	}
+	return 0;
+}
+
+size_t PawnTree::nameHitSize(const Atom name) const {
+	const std::vector<std::shared_ptr<Pawn>>* named = name_map.find(name);
+	return named ? named->size() : 0;
 }
 
 size_t PawnTree::idHitSize(uint32_t id) const {
@@ -83,26 +110,46 @@ void PawnTree::addToRoot(const std::shared_ptr<Pawn>& pawn) {
 	mountPawn(pawn);
 }
 
+void PawnTree::addToRoot(const std::vector<std::shared_ptr<Pawn>>& batch) {
+	root->children.reserve(root->children.size() + batch.size());
+
+	for (const std::shared_ptr<Pawn>& pawn : batch) {
+		addToRoot(pawn);
+	}
+}
+
 void PawnTree::mountPawn(const std::shared_ptr<Pawn>& pawn) {
-	bool isCopy = false;
+	if (deferChange([this, pawn] () { mountPawn(pawn); })) {
+		return;
+	}
+
 	bool isChanged = pawn->unregisteredChildAdded();
 
-	if (id_map.count(pawn->getEntityID()) > 0) {
-		auto range = id_map.equal_range(pawn->getEntityID());
-		for (auto r = range.first; r != range.second; ++r) {
-			if (r->second == pawn) {
-				isCopy = true;
-			}
-		}
+	auto mounted = id_map.find(pawn->getEntityID());
+	bool isCopy = mounted != id_map.end() && mounted->second == pawn;
+
+	if (!pawn_slots.contains(pawn->handle)) {
+		pawn->handle = pawn_slots.insert(pawn.get());
 	}
 
+	pawn->setBoard(root->board);
+
 	if (!pawn->physics_component.expired()) {
 		physics_components_to_update.insert(pawn->physics_component.lock());
 	}
 
+	for (const std::shared_ptr<Component>& component: pawn->components) {
+		registerComponent(component.get());
+	}
+
+	// the pawn may have a new parent, so its world transform needs to be recomputed
+	if (auto* spatial = dynamic_cast<SpatialPawn*>(pawn.get())) {
+		spatial->markTransformDirty();
+	}
+
 	//TODO test if it works
 	if (!isCopy) {
-		const std::string p_name = pawn->getName();
+		const Atom p_name = pawn->getNameAtom();
 		const uint32_t p_id = pawn->getEntityID();
 		addPawnToHash(p_name, p_id, pawn);
 	}
@@ -113,6 +160,56 @@ void PawnTree::mountPawn(const std::shared_ptr<Pawn>& pawn) {
 	}
 }
 
+void PawnTree::unmountPawn(const std::shared_ptr<Pawn>& pawn) {
+
+	// already unmounted as a part of a removed parent
+	if (!pawn_slots.remove(pawn->handle)) {
+		return;
+	}
+
+	unregisterComponents(pawn.get());
+
+	if (std::shared_ptr<PhysicsComponent> physics = pawn->physics_component.lock()) {
+		physics_components_to_update.erase(physics);
+	}
+
+	if (pawn->is_tracked_on_hash) {
+		removeFromMaps(pawn.get());
+	}
+
+	if (auto* spatial = dynamic_cast<SpatialPawn*>(pawn.get())) {
+		spatial_index.remove(spatial);
+	}
+
+	pawn->root_pawn.reset();
+
+	for (const std::shared_ptr<Pawn>& pawn_child: pawn->getChildren()) {
+		unmountPawn(pawn_child);
+	}
+}
+
+Pawn* PawnTree::getPawn(const PawnHandle handle) {
+	Pawn** pawn = pawn_slots.get(handle);
+	return pawn ? *pawn : nullptr;
+}
+
+Component* PawnTree::getComponent(const ComponentHandle handle) {
+	Component** component = component_slots.get(handle);
+	return component ? *component : nullptr;
+}
+
+std::vector<Pawn*> PawnTree::findPawnsWithComponents(const ComponentSignature signature) {
+	std::vector<Pawn*> result;
+
+	pawn_slots.forEach([&] (Pawn* pawn) {
+		if (pawn->signature.contains(signature)) {
+			result.push_back(pawn);
+		}
+	});
+
+	return result;
+}
+
 void PawnTree::updatePawnsChildren(const std::shared_ptr<Pawn>& pawn) {
 	for (std::shared_ptr<Pawn>& pawn_child: pawn->getChildren()) {
 		mountPawn(pawn_child);
@@ -123,20 +220,125 @@ std::shared_ptr<RootPawn> PawnTree::getRoot() {
 	return root;
 }
 
-void PawnTree::updateTree(double delta, std::mutex& mtx) {
+void PawnTree::updateTree(double delta, std::mutex& mtx, PhasedTaskDelegator* delegator, glm::vec3 viewer) {
+	std::lock_guard lock {mtx};
+	std::pmr::vector<std::shared_ptr<Pawn>> deferred {&FrameArena::current()};
+
+	scheduler.beginFrame(viewer);
+
 	for (std::shared_ptr<Pawn>& pawn_child: root->getChildren()) {
-		updateTreeRecursion(pawn_child, delta, mtx);
+		updateTreeRecursion(pawn_child, delta, delegator ? &deferred : nullptr);
 	}
+
+	if (!deferred.empty()) {
+		parallel_phase = true;
+
+		// whole subtrees are updated on the same thread, so the update order inside them is preserved,
+		// forEach() returns only after all chunks are done so it also acts as the phase barrier
+		parallel::forEach(delegator->getPool(), 0, deferred.size(), [&] (size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i ++) {
+				updateTreeRecursion(deferred[i], delta, nullptr);
+			}
+		});
+
+		parallel_phase = false;
+		applyDeferredChanges();
+	}
+
+	updateTicks(delta, delegator);
+	flushTransforms();
+
+	scheduler.endFrame();
 }
 
-void PawnTree::updateTreeRecursion(std::shared_ptr<Pawn> pawn_to_update, double delta, std::mutex& mtx) {
-	mtx.lock();
-	pawn_to_update->onUpdate(delta);
-	mtx.unlock();
+void PawnTree::updateTreeRecursion(const std::shared_ptr<Pawn>& pawn_to_update, double delta, std::pmr::vector<std::shared_ptr<Pawn>>* deferred) {
+	if (deferred && pawn_to_update->isThreadSafe()) {
+		deferred->push_back(pawn_to_update);
+		return;
+	}
+
+	if (scheduler.schedule(pawn_to_update.get(), delta)) {
+		pawn_to_update->onUpdate(pawn_to_update->update_delta);
+	}
 
 	//TODO maybe create iterator of some kind with lambda
 	for (std::shared_ptr<Pawn>& pawn_child: pawn_to_update->getChildren()) {
-		updateTreeRecursion(pawn_child, delta, mtx);
+		updateTreeRecursion(pawn_child, delta, deferred);
+	}
+}
+
+void PawnTree::updateTicks(double delta, PhasedTaskDelegator* delegator) {
+
+	// components can register and unregister during the update, so don't use iterators here
+	update_ticks.beginIteration();
+
+	for (size_t i = 0; i < update_ticks.size(); i ++) {
+		Component* component = update_ticks[i];
+
+		// components are updated together with their pawn, see UpdateScheduler
+		if (component && component->parent->update_due) {
+			component->onUpdate(Context(component->parent->update_delta, component->parent));
+		}
+	}
+
+	update_ticks.endIteration();
+
+	if (delegator == nullptr) {
+		parallel_update_ticks.beginIteration();
+
+		for (size_t i = 0; i < parallel_update_ticks.size(); i ++) {
+			Component* component = parallel_update_ticks[i];
+
+			if (component && component->parent->update_due) {
+				component->onUpdate(Context(component->parent->update_delta, component->parent));
+			}
+		}
+
+		parallel_update_ticks.endIteration();
+		return;
+	}
+
+	if (parallel_update_ticks.size() > 0) {
+		parallel_phase = true;
+		parallel_update_ticks.beginIteration();
+
+		// registrations are deferred during the phase, so the size can't change, but destroyed components still leave holes
+		parallel::forEach(delegator->getPool(), 0, parallel_update_ticks.size(), [&] (size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i ++) {
+				Component* component = parallel_update_ticks[i];
+
+				if (component && component->parent->update_due) {
+					component->onUpdate(Context(component->parent->update_delta, component->parent));
+				}
+			}
+		});
+
+		parallel_update_ticks.endIteration();
+		parallel_phase = false;
+		applyDeferredChanges();
+	}
+}
+
+bool PawnTree::deferChange(std::function<void()> change) {
+	if (!parallel_phase) {
+		return false;
+	}
+
+	std::lock_guard lock {deferred_mutex};
+	deferred_changes.push_back(std::move(change));
+	return true;
+}
+
+void PawnTree::applyDeferredChanges() {
+	std::vector<std::function<void()>> changes;
+
+	{
+		std::lock_guard lock {deferred_mutex};
+		changes.swap(deferred_changes);
+	}
+
+	for (std::function<void()>& change : changes) {
+		change();
 	}
 }
 
@@ -144,6 +346,10 @@ void PawnTree::fixedUpdateTree() {
 	for (std::shared_ptr<Pawn>& pawn_child: root->getChildren()) {
 		fixedUpdateTreeRecursion(pawn_child);
 	}
+
+	fixedUpdateTicks();
+	animations.update(TICK_DURATION);
+	flushTransforms();
 }
 
 void PawnTree::fixedUpdateTreeRecursion(std::shared_ptr<Pawn> pawn_to_fixed_update) {
@@ -155,6 +361,18 @@ void PawnTree::fixedUpdateTreeRecursion(std::shared_ptr<Pawn> pawn_to_fixed_upda
 	}
 }
 
+void PawnTree::fixedUpdateTicks() {
+	fixed_update_ticks.beginIteration();
+
+	for (size_t i = 0; i < fixed_update_ticks.size(); i ++) {
+		if (Component* component = fixed_update_ticks[i]) {
+			component->onFixedUpdate(FixedContext {component->parent});
+		}
+	}
+
+	fixed_update_ticks.endIteration();
+}
+
 std::string PawnTree::toString() {
 	return printStart(false);
 }
@@ -165,10 +383,18 @@ std::string PawnTree::toStringVerbose() {
 }
 
 void PawnTree::registerPhysicsComponent(const std::shared_ptr<PhysicsComponent>& physics_component) {
+	if (deferChange([this, physics_component] () { registerPhysicsComponent(physics_component); })) {
+		return;
+	}
+
 	physics_components_to_update.insert(physics_component);
 }
 
 void PawnTree::removePhysicsComponent(const std::shared_ptr<PhysicsComponent>& physics_component) {
+	if (deferChange([this, physics_component] () { removePhysicsComponent(physics_component); })) {
+		return;
+	}
+
 	physics_components_to_update.erase(physics_component);
 }
 
@@ -213,12 +439,159 @@ std::string PawnTree::recursiveString(const std::shared_ptr<Pawn>& p, const int
 	return result;
 }
 
-void PawnTree::addPawnToHash(const std::string& p_name, uint32_t p_id, const std::shared_ptr<Pawn>& pawn) {
-	name_map.insert(std::pair<std::string, std::shared_ptr<Pawn>>(p_name, pawn));
-	id_map.insert(std::pair<uint32_t, std::shared_ptr<Pawn>>(p_id, pawn));
+void PawnTree::addPawnToHash(const Atom p_name, uint32_t p_id, const std::shared_ptr<Pawn>& pawn) {
+	std::vector<std::shared_ptr<Pawn>>& named = name_map[p_name];
+	pawn->name_index = named.size();
+	named.push_back(pawn);
+
+	id_map.emplace(p_id, pawn);
 	pawn->setTracked(true);
 }
 
 std::set<std::shared_ptr<PhysicsComponent>> PawnTree::getPhysicsComponents() {
 	return physics_components_to_update;
 }
+
+void PawnTree::registerComponent(Component* component) {
+
+	// components of mounted pawns are only released by the removal, which runs after the parallel phase
+	if (deferChange([this, component] () { registerComponent(component); })) {
+		return;
+	}
+
+	if (!component_slots.contains(component->handle)) {
+		component->handle = component_slots.insert(component);
+	}
+
+	if (auto* animation = dynamic_cast<MatrixAnimation*>(component)) {
+		animations.insert(animation);
+	}
+
+	const uint8_t ticking = component->ticking;
+
+	if (ticking & Component::TICK_UPDATE) {
+		(isInThreadSafeSubtree(component->parent) ? parallel_update_ticks : update_ticks).insert(component);
+	} else if (ComponentArray* array = component->slots[ComponentSlot::UPDATE].array) {
+		array->remove(component);
+	}
+
+	if (ticking & Component::TICK_FIXED_UPDATE) {
+		fixed_update_ticks.insert(component);
+	} else {
+		fixed_update_ticks.remove(component);
+	}
+}
+
+void PawnTree::registerComponentsRecursion(const std::shared_ptr<Pawn>& pawn) {
+	for (const std::shared_ptr<Component>& component: pawn->components) {
+		registerComponent(component.get());
+	}
+
+	for (const std::shared_ptr<Pawn>& pawn_child: pawn->getChildren()) {
+		registerComponentsRecursion(pawn_child);
+	}
+}
+
+void PawnTree::unregisterComponents(Pawn* pawn) {
+	for (const std::shared_ptr<Component>& component: pawn->components) {
+		ComponentArray::removeFromAll(component.get());
+		component_slots.remove(component->handle);
+
+		if (auto* animation = dynamic_cast<MatrixAnimation*>(component.get())) {
+			animations.remove(animation);
+		}
+		component->handle = {};
+	}
+}
+
+bool PawnTree::isInThreadSafeSubtree(const Pawn* pawn) {
+	while (pawn != nullptr) {
+		if (pawn->isThreadSafe()) {
+			return true;
+		}
+
+		pawn = pawn->parent.lock().get();
+	}
+
+	return false;
+}
+
+void PawnTree::queueTransform(SpatialPawn* pawn) {
+	std::lock_guard lock {transform_mutex};
+	dirty_transforms.push_back(pawn);
+}
+
+void PawnTree::flushTransforms() {
+	changed_transforms.clear();
+
+	if (dirty_transforms.empty()) {
+		return;
+	}
+
+	// components notified below can move pawns again, those changes land in the next flush
+	flushed_transforms.swap(dirty_transforms);
+	transform_epoch ++;
+
+	for (SpatialPawn* spatial: flushed_transforms) {
+
+		// already recomputed as a part of a moved parent subtree
+		if (!spatial->transform_dirty) {
+			continue;
+		}
+
+		refreshTransformRecursion(spatial, spatial->getParentWorldMatrix());
+	}
+
+	flushed_transforms.clear();
+
+	for (SpatialPawn* spatial: changed_transforms) {
+		spatial_index.update(spatial);
+
+		for (const std::shared_ptr<Component>& component: spatial->components) {
+			component->onTransformChanged();
+		}
+	}
+}
+
+void PawnTree::refreshTransformRecursion(Pawn* pawn, const glm::mat4& parent_world) {
+	glm::mat4 world = parent_world;
+
+	if (auto* spatial = dynamic_cast<SpatialPawn*>(pawn)) {
+		world = parent_world * spatial->getLocalMatrix();
+		spatial->affineTransformMatrix = glm::mat4x3(world);
+		spatial->transform_dirty = false;
+
+		// a child can be queued before its parent, don't report it twice
+		if (spatial->transform_epoch != transform_epoch) {
+			spatial->transform_epoch = transform_epoch;
+			changed_transforms.push_back(spatial);
+		}
+	}
+
+	for (const std::shared_ptr<Pawn>& pawn_child: pawn->getChildren()) {
+		refreshTransformRecursion(pawn_child.get(), world);
+	}
+}
+
+const std::vector<SpatialPawn*>& PawnTree::getChangedTransforms() const {
+	return changed_transforms;
+}
+
+SpatialIndex& PawnTree::getSpatialIndex() {
+	return spatial_index;
+}
+
+UpdateScheduler& PawnTree::getScheduler() {
+	return scheduler;
+}
+
+AnimationSystem& PawnTree::getAnimations() {
+	return animations;
+}
+
+void PawnTree::reserve(size_t pawns, size_t components) {
+	pawn_slots.reserve(pawn_slots.size() + pawns);
+	component_slots.reserve(component_slots.size() + components);
+	id_map.reserve(id_map.size() + pawns);
+	name_map.reserve(name_map.size() + pawns);
+}
@@ -1,27 +1,88 @@
 #pragma once
 #include "entity/component/physics.hpp"
+#include "entity/component/render.hpp"
+#include "entity/component/sound.hpp"
+#include "entity/component/matrixAnimation.hpp"
 #include "entity/pawns/rootPawn.hpp"
+#include "storage.hpp"
+#include "shared/thread/phased.hpp"
+#include "shared/thread/parallel.hpp"
+#include "shared/flat.hpp"
+#include "spatial.hpp"
 
 class PawnTree {
 	friend Board;
+	friend Pawn;
 
 protected:
 	std::shared_ptr<RootPawn> root;
 
-	std::unordered_multimap<std::string, std::shared_ptr<Pawn>> name_map;
-	std::unordered_multimap<uint32_t, std::shared_ptr<Pawn>> id_map;
+	FlatMap<Atom, std::vector<std::shared_ptr<Pawn>>> name_map;
+	std::unordered_map<uint32_t, std::shared_ptr<Pawn>> id_map;
+
+	SlotMap<Pawn*> pawn_slots;
+	SlotMap<Component*> component_slots;
 	std::set<std::shared_ptr<PhysicsComponent>> physics_components_to_update;
 
+	///components are ticked from flat lists of only the components that tick in each phase, render, sound and physics
+	///components don't tick at all (they are synced when their pawn moves) and animations are sampled by the AnimationSystem
+	ComponentArray update_ticks {ComponentSlot::UPDATE};
+	ComponentArray parallel_update_ticks {ComponentSlot::UPDATE};
+	ComponentArray fixed_update_ticks {ComponentSlot::FIXED_UPDATE};
+
+	std::mutex transform_mutex;
+	std::vector<SpatialPawn*> dirty_transforms;
+	std::vector<SpatialPawn*> flushed_transforms;
+	std::vector<SpatialPawn*> changed_transforms;
+	uint32_t transform_epoch;
+
+	SpatialIndex spatial_index;
+	UpdateScheduler scheduler;
+
+	///all the animations are sampled by the system, in one batched pass over their packed state
+	AnimationSystem animations;
+
+	///set while thread-safe subtrees and parallel ticks run on the task pool, see deferChange()
+	std::atomic<bool> parallel_phase;
+	std::mutex deferred_mutex;
+	std::vector<std::function<void()>> deferred_changes;
+
+	/**
+	 * applies the changes deferred during the parallel phase, in the order in which each thread made them
+	 */
+	void applyDeferredChanges();
+
+	/**
+	 * performs standard game update on all the tree elements, triggered by updateTree() function,
+	 * if deferred is not null thread-safe subtrees are skipped and appended to it instead
+	 */
+	void updateTreeRecursion(const std::shared_ptr<Pawn>& pawn_to_update, double delta, std::pmr::vector<std::shared_ptr<Pawn>>* deferred);
+
+	/**
+	 * ticks all the components registered for standard update
+	 */
+	void updateTicks(double delta, PhasedTaskDelegator* delegator);
+
 	/**
-	 * performs standard game update on all the tree elements, triggered by updateTree() function
+	 * ticks all the components registered for fixed update
 	 */
-	void updateTreeRecursion(std::shared_ptr<Pawn> pawn_to_update, double delta, std::mutex& mtx);
+	void fixedUpdateTicks();
 
 	/**
 	 * performs standard game update on all the tree elements, triggered by fixedUpdateTree() function
 	 */
 	void fixedUpdateTreeRecursion(std::shared_ptr<Pawn> pawn_to_fixed_update);
 
+	/**
+	 * recomputes world transforms of the pawn and all its children, non-spatial pawns pass the parent transform through
+	 */
+	void refreshTransformRecursion(Pawn* pawn, const glm::mat4& parent_world);
+
+	/**
+	 * returns true if the pawn or any of its parents is marked as thread-safe
+	 */
+	static bool isInThreadSafeSubtree(const Pawn* pawn);
+
 	/**
 	 * returns part of a pawn tree in a string format, triggered by print() function
 	 */
@@ -33,14 +94,14 @@ protected:
 	std::string printStart(bool verbose);
 
 	/**
-	 * removes a pawn from hashmaps, returns true if operation was successful
+	 * removes a pawn from hashmaps in O(1), returns true if operation was successful
 	 */
-	bool removeFromMaps(const std::string& name, uint32_t id);
+	bool removeFromMaps(Pawn* pawn);
 
 	/**
 	 * adds pawn to a hashmaps
 	 */
-	void addPawnToHash(const std::string& p_name, uint32_t p_id, const std::shared_ptr<Pawn>& pawn);
+	void addPawnToHash(Atom p_name, uint32_t p_id, const std::shared_ptr<Pawn>& pawn);
 
 public:
 	PawnTree();
@@ -50,6 +111,11 @@ public:
 	 */
 	std::shared_ptr<Pawn> findByName(const std::string& name);
 
+	/**
+	 * finds a pawn by interned name, faster than the string variant, intern the name once with Atom::of() and reuse it
+	 */
+	std::shared_ptr<Pawn> findByName(Atom name);
+
 	/**
 	 * finds a pawn by id
 	 */
@@ -60,6 +126,11 @@ public:
 	 */
 	std::vector<std::shared_ptr<Pawn>> findAllByName(const std::string& name);
 
+	/**
+	 * finds all pawns with given interned name
+	 */
+	std::vector<std::shared_ptr<Pawn>> findAllByName(Atom name);
+
 	/**
 	 * finds all pawns with given id
 	 */
@@ -70,21 +141,58 @@ public:
 	 */
 	size_t nameHitSize(const std::string& name) const;
 
+	/**
+	 * returns size of entry in map with given key (interned name)
+	 */
+	size_t nameHitSize(Atom name) const;
+
 	/**
 	 * returns size of entry in map with given key (id)
 	 */
 	size_t idHitSize(uint32_t id) const;
 
+	/**
+	 * preallocates the hashmaps and handle tables for the given number of additional pawns and components,
+	 * use before mounting many pawns at once, see BoardSnapshot
+	 */
+	void reserve(size_t pawns, size_t components);
+
 	/**
 	 * adds a pawn to RootPawn
 	 */
 	void addToRoot(const std::shared_ptr<Pawn>& pawn);
 
+	/**
+	 * adds all the pawns to RootPawn in one batch
+	 */
+	void addToRoot(const std::vector<std::shared_ptr<Pawn>>& batch);
+
 	/**
 	 * updates/inserts a pawn to a PawnTree
 	 */
 	void mountPawn(const std::shared_ptr<Pawn>& pawn);
 
+	/**
+	 * removes a pawn and all its children from the PawnTree structures (hashmaps, tick lists, handles),
+	 * the pawn needs to be detached from its parent first, see Board::dequeueRemove()
+	 */
+	void unmountPawn(const std::shared_ptr<Pawn>& pawn);
+
+	/**
+	 * returns pawn referenced by the handle, or nullptr if it was removed from the tree
+	 */
+	Pawn* getPawn(PawnHandle handle);
+
+	/**
+	 * returns component referenced by the handle, or nullptr if it was removed from the tree
+	 */
+	Component* getComponent(ComponentHandle handle);
+
+	/**
+	 * returns all pawns that have components of every class in the signature
+	 */
+	std::vector<Pawn*> findPawnsWithComponents(ComponentSignature signature);
+
 	/**
 	 * updates children of given pawn in a PawnTree
 	 */
@@ -96,9 +204,10 @@ public:
 	std::shared_ptr<RootPawn> getRoot();
 
 	/**
-	 * performs standard game update on all the tree elements
+	 * performs standard game update on all the tree elements, if delegator is given thread-safe subtrees
+	 * are updated concurrently after all the other pawns, update tiers are picked by the distance to the viewer
 	 */
-	void updateTree(double delta, std::mutex& mtx);
+	void updateTree(double delta, std::mutex& mtx, PhasedTaskDelegator* delegator = nullptr, glm::vec3 viewer = {0, 0, 0});
 
 	/**
 	 * performs fixed game update on all the tree elements
@@ -129,4 +238,60 @@ public:
 	 * returns
 	 */
 	std::set<std::shared_ptr<PhysicsComponent>> getPhysicsComponents();
+
+	/**
+	 * queues the change and returns true if called during the parallel phase of an update, the changes are applied
+	 * on the updating thread right after the phase, mounts, component registrations and renames made by thread-safe
+	 * pawns go through here so that the maps and tick lists of the tree are only ever modified by one thread
+	 */
+	bool deferChange(std::function<void()> change);
+
+	/**
+	 * adds a component to the tick lists of the phases the component ticks in, can be called again
+	 * to move the component after its ticking or thread safety changed
+	 */
+	void registerComponent(Component* component);
+
+	/**
+	 * registers components of a pawn and all its children, see registerComponent()
+	 */
+	void registerComponentsRecursion(const std::shared_ptr<Pawn>& pawn);
+
+	/**
+	 * removes all the components of a pawn from the tick lists, and releases their handles
+	 */
+	void unregisterComponents(Pawn* pawn);
+
+	/**
+	 * queues the world transform of a pawn to be recomputed on the next flushTransforms(), can be called from parallel updates
+	 */
+	void queueTransform(SpatialPawn* pawn);
+
+	/**
+	 * recomputes world transforms of all the subtrees that moved since the last flush
+	 * and notifies components of the changed pawns, static pawns cost nothing here
+	 */
+	void flushTransforms();
+
+	/**
+	 * returns pawns whose world transform changed during the last flushTransforms(),
+	 * the pointers are only valid until the next update of the board
+	 */
+	const std::vector<SpatialPawn*>& getChangedTransforms() const;
+
+	/**
+	 * returns the index of world positions of all the spatial pawns in the tree,
+	 * it's updated together with the world transforms, see flushTransforms()
+	 */
+	SpatialIndex& getSpatialIndex();
+
+	/**
+	 * returns the scheduler that decides which pawns are updated in each frame
+	 */
+	UpdateScheduler& getScheduler();
+
+	/**
+	 * returns the system that samples all the MatrixAnimation components of this tree
+	 */
+	AnimationSystem& getAnimations();
 };
@@ -0,0 +1,172 @@
+#include "prefab.hpp"
+#include "board.hpp"
+#include "shared/logger.hpp"
+
+/*
+ * Prefab
+ */
+
+Prefab::Prefab(Pawn& pawn) {
+
+	// depth-first order, parents are always captured before their children
+	std::vector<std::pair<Pawn*, uint32_t>> stack {{&pawn, 0}};
+
+	while (!stack.empty()) {
+		auto [current, parent] = stack.back();
+		stack.pop_back();
+
+		if (current->getState() == PawnState::REMOVED) {
+			continue;
+		}
+
+		BoardSnapshot::PawnType* type = BoardSnapshot::findPawnType(*current);
+
+		if (type == nullptr) {
+			out::warn("Skipping pawn '%s' of unregistered type in prefab", current->getName().c_str());
+			continue;
+		}
+
+		Node& node = nodes.emplace_back();
+		node.type = type;
+		node.name = current->getNameAtom();
+		node.parent = parent;
+		node.flags = current->isThreadSafe() ? BoardSnapshot::THREAD_SAFE : 0;
+		node.priority = current->getUpdatePriority();
+		node.first_component = components.size();
+		node.component_count = 0;
+
+		if (auto* spatial = dynamic_cast<SpatialPawn*>(current)) {
+			node.flags |= BoardSnapshot::SPATIAL;
+			node.position = spatial->getPosition();
+			node.rotation = spatial->getRotation();
+			node.scale = spatial->getScale();
+			node.velocity = spatial->getVelocity();
+			node.angular_velocity = spatial->getAngularVelocity();
+		}
+
+		for (const std::shared_ptr<Component>& component : current->getComponents()) {
+			if (BoardSnapshot::ComponentType* component_type = BoardSnapshot::findComponentType(*component)) {
+				const size_t offset = parameters.bytes.size();
+				component_type->saver(*component, parameters);
+
+				components.push_back({component_type, offset, parameters.bytes.size() - offset});
+				node.component_count ++;
+			}
+		}
+
+		const uint32_t index = nodes.size();
+		std::vector<std::shared_ptr<Pawn>>& children = current->getChildren();
+
+		for (auto it = children.rbegin(); it != children.rend(); ++ it) {
+			stack.emplace_back(it->get(), index);
+		}
+	}
+}
+
+std::shared_ptr<Pawn> Prefab::build(std::vector<std::shared_ptr<Pawn>>& scratch) const {
+	scratch.clear();
+
+	for (const Node& node : nodes) {
+		std::shared_ptr<Pawn> pawn = node.type->factory();
+		pawn->setName(node.name);
+		pawn->setThreadSafe(node.flags & BoardSnapshot::THREAD_SAFE);
+		pawn->setUpdatePriority(node.priority);
+
+		if (node.flags & BoardSnapshot::SPATIAL) {
+			if (auto* spatial = dynamic_cast<SpatialPawn*>(pawn.get())) {
+				spatial->setPosition(node.position);
+				spatial->setRotation(node.rotation);
+				spatial->setScale(node.scale);
+				spatial->setVelocity(node.velocity);
+				spatial->setAngularVelocity(node.angular_velocity);
+			}
+		}
+
+		for (uint32_t i = 0; i < node.component_count; i ++) {
+			const ComponentNode& component = components[node.first_component + i];
+			SnapshotReader reader {parameters.bytes.data() + component.offset, component.size, &parameters.strings};
+
+			if (!component.type->loader(*pawn, reader) || reader.isFailed()) {
+				out::warn("Failed to instantiate component '%s' of prefab pawn '%s'", component.type->name.str().c_str(), pawn->getName().c_str());
+			}
+		}
+
+		if (node.parent != 0) {
+			scratch[node.parent - 1]->addChild(pawn);
+		}
+
+		scratch.push_back(std::move(pawn));
+	}
+
+	return scratch.front();
+}
+
+void Prefab::reserve(size_t count) const {
+	std::unordered_map<BoardSnapshot::PawnType*, size_t> pawn_counts;
+	std::unordered_map<BoardSnapshot::ComponentType*, size_t> component_counts;
+
+	for (const Node& node : nodes) {
+		pawn_counts[node.type] ++;
+	}
+
+	for (const ComponentNode& component : components) {
+		component_counts[component.type] ++;
+	}
+
+	for (auto [type, per_copy] : pawn_counts) {
+		type->reserve(per_copy * count);
+	}
+
+	for (auto [type, per_copy] : component_counts) {
+		type->reserve(per_copy * count);
+	}
+}
+
+size_t Prefab::size() const {
+	return nodes.size();
+}
+
+bool Prefab::empty() const {
+	return nodes.empty();
+}
+
+std::shared_ptr<Pawn> Prefab::instantiate() const {
+	if (nodes.empty()) {
+		return nullptr;
+	}
+
+	std::vector<std::shared_ptr<Pawn>> scratch;
+	scratch.reserve(nodes.size());
+
+	return build(scratch);
+}
+
+std::vector<std::shared_ptr<Pawn>> Prefab::instantiate(Board& board, size_t count, const std::function<void(Pawn&, size_t)>& placer) const {
+	if (nodes.empty() || count == 0) {
+		return {};
+	}
+
+	std::vector<std::shared_ptr<Pawn>> roots;
+	std::vector<std::shared_ptr<Pawn>> scratch;
+	roots.reserve(count);
+	scratch.reserve(nodes.size());
+
+	// pools are created by the first allocation, so the rest of the batch is reserved after the first copy
+	roots.push_back(build(scratch));
+	reserve(count - 1);
+
+	for (size_t i = 1; i < count; i ++) {
+		roots.push_back(build(scratch));
+	}
+
+	if (placer) {
+		for (size_t i = 0; i < count; i ++) {
+			placer(*roots[i], i);
+		}
+	}
+
+	board.getTree().reserve(count * nodes.size(), count * components.size());
+	board.addPawnsToRoot(roots);
+
+	return roots;
+}
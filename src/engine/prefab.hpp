@@ -0,0 +1,79 @@
+#pragma once
+#include "snapshot.hpp"
+
+class Board;
+
+/**
+ * Pawn subtree captured once and instantiated many times, components are captured as their snapshot parameters,
+ * so only pawn and component types registered in BoardSnapshot are a part of the prefab, other components are skipped
+ */
+class Prefab {
+protected:
+	struct Node {
+		BoardSnapshot::PawnType* type;
+		Atom name;
+
+		///index of the parent node plus one, 0 for the root of the prefab
+		uint32_t parent;
+		uint8_t flags;
+		UpdatePriority priority;
+
+		glm::vec3 position;
+		glm::quat rotation;
+		glm::vec3 scale;
+		glm::vec3 velocity;
+		glm::vec3 angular_velocity;
+
+		uint32_t first_component;
+		uint32_t component_count;
+	};
+
+	struct ComponentNode {
+		BoardSnapshot::ComponentType* type;
+		size_t offset;
+		size_t size;
+	};
+
+	std::vector<Node> nodes;
+	std::vector<ComponentNode> components;
+	SnapshotWriter parameters;
+
+	/**
+	 * creates one copy of the captured subtree, scratch is used to track the parents, returns the root of the copy
+	 */
+	std::shared_ptr<Pawn> build(std::vector<std::shared_ptr<Pawn>>& scratch) const;
+
+	/**
+	 * reserves pool blocks for the given number of copies
+	 */
+	void reserve(size_t count) const;
+
+public:
+	Prefab() = default;
+
+	/**
+	 * captures the pawn and its whole subtree, the pawn is not modified and can be removed afterwards
+	 */
+	explicit Prefab(Pawn& pawn);
+
+	/**
+	 * returns the number of pawns in one copy of the prefab
+	 */
+	size_t size() const;
+
+	/**
+	 * returns true if nothing was captured
+	 */
+	bool empty() const;
+
+	/**
+	 * creates a single detached copy of the prefab, returns nullptr if the prefab is empty
+	 */
+	std::shared_ptr<Pawn> instantiate() const;
+
+	/**
+	 * creates count copies of the prefab and adds them to the root of the board in one batch, pools and the board maps are
+	 * reserved up front, the placer (if given) is called with the root of every copy and its index before it's mounted
+	 */
+	std::vector<std::shared_ptr<Pawn>> instantiate(Board& board, size_t count, const std::function<void(Pawn&, size_t)>& placer = {}) const;
+};
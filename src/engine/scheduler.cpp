@@ -0,0 +1,124 @@
+#include "scheduler.hpp"
+#include "entity/pawn.hpp"
+
+/*
+ * UpdateScheduler
+ */
+
+UpdateScheduler::UpdateScheduler() {
+	enabled = false;
+	tiers = {{25.0f, 1}, {75.0f, 2}, {200.0f, 4}};
+	round_robin_slice = 64;
+	budget = 0;
+
+	viewer = {0, 0, 0};
+	frame = 0;
+
+	round_robin_index = 0;
+	round_robin_period = 1;
+
+	updated = 0;
+	deferred = 0;
+	last_updated = 0;
+	last_deferred = 0;
+}
+
+bool UpdateScheduler::isDueByTier(const Pawn* pawn) {
+	glm::vec3 position;
+
+	// pawns without a position are only scheduled by their priority
+	if (pawn->update_priority != UpdatePriority::LOW) {
+		if (!pawn->getSchedulingPosition(position)) {
+			return true;
+		}
+
+		const float distance2 = glm::length2(position - viewer);
+
+		for (const UpdateTier& tier : tiers) {
+			if (distance2 <= tier.distance * tier.distance) {
+				return (frame + pawn->getEntityID()) % std::max<uint32_t>(1, tier.interval) == 0;
+			}
+		}
+	}
+
+	// every frame the next slice of distant pawns is updated
+	const size_t index = round_robin_index.fetch_add(1, std::memory_order_relaxed);
+	return (index + frame) % round_robin_period == 0;
+}
+
+void UpdateScheduler::beginFrame(const glm::vec3 viewer) {
+	this->viewer = viewer;
+	this->frame ++;
+	this->frame_timer = Timer();
+
+	round_robin_index = 0;
+	updated = 0;
+	deferred = 0;
+}
+
+void UpdateScheduler::endFrame() {
+	const size_t sliced = round_robin_index.load();
+	round_robin_period = std::max<size_t>(1, (sliced + round_robin_slice - 1) / std::max<size_t>(1, round_robin_slice));
+
+	last_updated = updated.load();
+	last_deferred = deferred.load();
+}
+
+bool UpdateScheduler::schedule(Pawn* pawn, const double delta) {
+	pawn->pending_delta += delta;
+	bool due = true;
+
+	if (enabled && pawn->update_priority != UpdatePriority::CRITICAL) {
+		due = isDueByTier(pawn);
+
+		// pawns deferred in the previous frame bypass the budget, the tree is walked in the same order
+		// every frame, so otherwise the pawns at its end would never be updated on a board that stays over budget
+		if (pawn->update_overdue) {
+			due = true;
+		} else if (due && budget > 0) {
+			const double elapsed = frame_timer.milliseconds();
+			const double limit = pawn->update_priority == UpdatePriority::LOW ? budget : budget * NORMAL_OVERRUN;
+
+			if (elapsed > limit) {
+				pawn->update_overdue = true;
+				deferred.fetch_add(1, std::memory_order_relaxed);
+				due = false;
+			}
+		}
+	}
+
+	pawn->update_due = due;
+
+	if (due) {
+		pawn->update_overdue = false;
+		pawn->update_delta = pawn->pending_delta;
+		pawn->pending_delta = 0;
+		updated.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	return due;
+}
+
+void UpdateScheduler::setEnabled(const bool value) {
+	enabled = value;
+}
+
+void UpdateScheduler::setTiers(const std::vector<UpdateTier>& tiers) {
+	this->tiers = tiers;
+}
+
+void UpdateScheduler::setRoundRobinSlice(const size_t pawns) {
+	round_robin_slice = pawns;
+}
+
+void UpdateScheduler::setBudget(const double milliseconds) {
+	budget = milliseconds;
+}
+
+size_t UpdateScheduler::getUpdatedCount() const {
+	return last_updated;
+}
+
+size_t UpdateScheduler::getDeferredCount() const {
+	return last_deferred;
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "external.hpp"
+#include "shared/timer.hpp"
+
+class Pawn;
+
+/**
+ * Hint for the UpdateScheduler, critical pawns are updated every frame and never deferred,
+ * low priority pawns are always time-sliced like the most distant ones
+ */
+enum struct UpdatePriority : uint8_t {
+	CRITICAL,
+	NORMAL,
+	LOW
+};
+
+/**
+ * Pawns closer to the camera than the distance are updated every interval frames
+ */
+struct UpdateTier {
+	float distance;
+	uint32_t interval;
+};
+
+/**
+ * Decides which pawns are updated in a frame, based on their distance to the camera, their priority
+ * and the time already spent on the frame, skipped pawns accumulate the elapsed time and receive it
+ * in their next update, disabled by default (all pawns are updated every frame)
+ */
+class UpdateScheduler {
+public:
+	/// normal priority pawns are only deferred after the budget is exceeded this many times
+	static constexpr double NORMAL_OVERRUN = 2.0;
+
+protected:
+	bool enabled;
+	std::vector<UpdateTier> tiers;
+	size_t round_robin_slice;
+	double budget;
+
+	glm::vec3 viewer;
+	uint64_t frame;
+	Timer frame_timer;
+
+	std::atomic<size_t> round_robin_index;
+	size_t round_robin_period;
+
+	std::atomic<size_t> updated;
+	std::atomic<size_t> deferred;
+	size_t last_updated;
+	size_t last_deferred;
+
+	/**
+	 * returns true if the pawn is due this frame according to its tier
+	 */
+	bool isDueByTier(const Pawn* pawn);
+
+public:
+	UpdateScheduler();
+
+	/**
+	 * starts a new frame, distances are measured from the viewer position
+	 */
+	void beginFrame(glm::vec3 viewer);
+
+	/**
+	 * finishes the frame, the round-robin period is adjusted to the number of time-sliced pawns seen in it
+	 */
+	void endFrame();
+
+	/**
+	 * decides if the pawn is updated this frame and sets its update delta, can be called concurrently for different pawns
+	 */
+	bool schedule(Pawn* pawn, double delta);
+
+	/**
+	 * enables or disables the scheduling, when disabled every pawn is updated every frame
+	 */
+	void setEnabled(bool value);
+
+	/**
+	 * sets the distance tiers, tiers need to be sorted by distance, pawns further than the last tier are time-sliced
+	 */
+	void setTiers(const std::vector<UpdateTier>& tiers);
+
+	/**
+	 * sets how many of the time-sliced pawns are updated in each frame
+	 */
+	void setRoundRobinSlice(size_t pawns);
+
+	/**
+	 * sets the per-frame time budget in milliseconds, after it is exceeded low priority updates are deferred to the next frame,
+	 * normal priority updates only after it is exceeded NORMAL_OVERRUN times, a deferred pawn is always updated
+	 * in the next frame (regardless of the budget), so no pawn waits more than one frame, 0 disables the budget
+	 */
+	void setBudget(double milliseconds);
+
+	/**
+	 * returns number of pawns updated in the last frame
+	 */
+	size_t getUpdatedCount() const;
+
+	/**
+	 * returns number of due pawn updates that were deferred in the last frame because of the budget
+	 */
+	size_t getDeferredCount() const;
+};
@@ -0,0 +1,435 @@
+#include "snapshot.hpp"
+#include "board.hpp"
+#include "shared/mapped.hpp"
+#include "shared/file.hpp"
+#include "shared/logger.hpp"
+
+/*
+ * SnapshotWriter
+ */
+
+void SnapshotWriter::writeAtom(Atom atom) {
+	uint32_t* index = string_map.find(atom);
+
+	if (index == nullptr) {
+		index = &(string_map[atom] = strings.size());
+		strings.push_back(atom);
+	}
+
+	write<uint32_t>(*index);
+}
+
+void SnapshotWriter::writeString(std::string_view string) {
+	write<uint32_t>(string.size());
+	bytes.insert(bytes.end(), string.begin(), string.end());
+}
+
+/*
+ * SnapshotReader
+ */
+
+SnapshotReader::SnapshotReader(const uint8_t* data, size_t size, const std::vector<Atom>* strings)
+: cursor(data), end(data + size), strings(strings), failed(false) {}
+
+const uint8_t* SnapshotReader::take(size_t size) {
+	if (failed || static_cast<size_t>(end - cursor) < size) {
+		failed = true;
+		return nullptr;
+	}
+
+	const uint8_t* bytes = cursor;
+	cursor += size;
+	return bytes;
+}
+
+Atom SnapshotReader::readAtom() {
+	const uint32_t index = read<uint32_t>();
+
+	if (strings == nullptr || index >= strings->size()) {
+		failed = true;
+		return {};
+	}
+
+	return (*strings)[index];
+}
+
+std::string_view SnapshotReader::readString() {
+	const uint32_t size = read<uint32_t>();
+	const uint8_t* bytes = take(size);
+
+	if (bytes == nullptr) {
+		return {};
+	}
+
+	return {reinterpret_cast<const char*>(bytes), size};
+}
+
+SnapshotReader SnapshotReader::slice(size_t size) {
+	const uint8_t* bytes = take(size);
+
+	if (bytes == nullptr) {
+		SnapshotReader empty {nullptr, 0, strings};
+		empty.failed = true;
+		return empty;
+	}
+
+	return {bytes, size, strings};
+}
+
+bool SnapshotReader::isFailed() const {
+	return failed;
+}
+
+/*
+ * BoardSnapshot
+ */
+
+BoardSnapshot::Registry& BoardSnapshot::registry() {
+	static Registry registry;
+	static std::atomic<bool> ready = false;
+	static std::recursive_mutex mutex;
+	static bool initialized = false;
+
+	// snapshots can be loaded on the worker threads, see BoardManager::streamBoard()
+	if (ready.load(std::memory_order_acquire)) {
+		return registry;
+	}
+
+	std::lock_guard lock {mutex};
+
+	// the engine types below register through this function too
+	if (initialized) {
+		return registry;
+	}
+
+	initialized = true;
+
+	registerPawn<Pawn>("Pawn");
+	registerPawn<SpatialPawn>("SpatialPawn");
+
+	registerComponent<RenderComponent>("RenderComponent", [] (RenderComponent& component, SnapshotWriter& writer) {
+		writer.write<uint32_t>(component.getShape());
+	}, [] (Pawn& pawn, SnapshotReader& reader) {
+		auto* spatial = dynamic_cast<SpatialPawn*>(&pawn);
+		if (!spatial) return false;
+
+		spatial->createComponent<RenderComponent>(static_cast<Models::Shape>(reader.read<uint32_t>()));
+		return true;
+	});
+
+	registerComponent<SoundComponent>("SoundComponent", [] (SoundComponent& component, SnapshotWriter& writer) {
+		writer.writeString(component.getPath());
+	}, [] (Pawn& pawn, SnapshotReader& reader) {
+		auto* spatial = dynamic_cast<SpatialPawn*>(&pawn);
+		if (!spatial) return false;
+
+		spatial->createComponent<SoundComponent>(std::string {reader.readString()});
+		return true;
+	});
+
+	registerComponent<MatrixAnimation>("MatrixAnimation", [] (MatrixAnimation& component, SnapshotWriter& writer) {
+		writer.write<uint32_t>(component.getAnimation());
+	}, [] (Pawn& pawn, SnapshotReader& reader) {
+		auto* spatial = dynamic_cast<SpatialPawn*>(&pawn);
+		if (!spatial) return false;
+
+		spatial->createComponent<MatrixAnimation>(static_cast<MatrixAnimation::AnimationType>(reader.read<uint32_t>()));
+		return true;
+	});
+
+	registerComponent<PhysicsComponent>("PhysicsComponent", [] (PhysicsComponent& component, SnapshotWriter& writer) {
+		Collider& collider = component.getCollider();
+
+		writer.write<uint8_t>(component.isStatic());
+		writer.write(component.getGravityScale());
+		writer.write(component.getMaterial());
+		writer.write(component.getMass());
+		writer.writeArray(collider.getVertices());
+		writer.writeArray(collider.getTriangles());
+		writer.write(collider.getCenterOfMass());
+		writer.write(collider.getInertiaTensor());
+	}, [] (Pawn& pawn, SnapshotReader& reader) {
+		auto* spatial = dynamic_cast<SpatialPawn*>(&pawn);
+		if (!spatial) return false;
+
+		const bool is_static = reader.read<uint8_t>();
+		const auto gravity_scale = reader.read<glm::vec3>();
+		const auto material = reader.read<Material>();
+		const auto mass = reader.read<float>();
+
+		// triangles go first, setVertices() recomputes the derived properties
+		Collider collider;
+		const auto vertices = reader.readArray<glm::vec3>();
+		collider.setTriangles(reader.readArray<glm::ivec3>());
+		collider.setVertices(vertices);
+		collider.setCenterOfMass(reader.read<glm::vec3>());
+		const auto inertia_tensor = reader.read<glm::mat3x3>();
+
+		// the component recomputes mass and inertia on construction, restore the saved values after it
+		auto physics = spatial->createComponent<PhysicsComponent>(collider, is_static, material, gravity_scale);
+		physics->setMass(mass);
+		physics->getCollider().setInertiaTensor(inertia_tensor);
+		return true;
+	});
+
+	ready.store(true, std::memory_order_release);
+	return registry;
+}
+
+BoardSnapshot::PawnType* BoardSnapshot::findPawnType(const Pawn& pawn) {
+	Registry& types = registry();
+	const auto it = types.pawns_by_type.find(typeid(pawn));
+	return it == types.pawns_by_type.end() ? nullptr : it->second;
+}
+
+BoardSnapshot::ComponentType* BoardSnapshot::findComponentType(const Component& component) {
+	Registry& types = registry();
+	const auto it = types.components_by_type.find(typeid(component));
+	return it == types.components_by_type.end() ? nullptr : it->second;
+}
+
+void BoardSnapshot::writePawn(Pawn& pawn, const PawnType& type, uint32_t parent, SnapshotWriter& writer, uint32_t& components) {
+	auto* spatial = dynamic_cast<SpatialPawn*>(&pawn);
+	uint8_t flags = 0;
+
+	if (pawn.isThreadSafe()) flags |= THREAD_SAFE;
+	if (spatial) flags |= SPATIAL;
+
+	writer.writeAtom(type.name);
+	writer.writeAtom(pawn.getNameAtom());
+	writer.write<uint32_t>(parent);
+	writer.write<uint8_t>(flags);
+	writer.write<uint8_t>(static_cast<uint8_t>(pawn.getUpdatePriority()));
+
+	if (spatial) {
+		const glm::quat rotation = spatial->getRotation();
+
+		writer.write(spatial->getPosition());
+		writer.write(glm::vec4 {rotation.w, rotation.x, rotation.y, rotation.z});
+		writer.write(spatial->getScale());
+		writer.write(spatial->getVelocity());
+		writer.write(spatial->getAngularVelocity());
+	}
+
+	std::vector<std::pair<Component*, ComponentType*>> saved;
+
+	for (const std::shared_ptr<Component>& component : pawn.getComponents()) {
+		if (ComponentType* component_type = findComponentType(*component)) {
+			saved.emplace_back(component.get(), component_type);
+		}
+	}
+
+	writer.write<uint32_t>(saved.size());
+	components += saved.size();
+
+	for (auto& [component, component_type] : saved) {
+		writer.writeAtom(component_type->name);
+
+		// the payload size is patched after the payload is written, so that unknown components can be skipped on load
+		const size_t offset = writer.bytes.size();
+		writer.write<uint32_t>(0);
+		component_type->saver(*component, writer);
+
+		const uint32_t size = writer.bytes.size() - offset - sizeof(uint32_t);
+		std::memcpy(writer.bytes.data() + offset, &size, sizeof(uint32_t));
+	}
+}
+
+std::shared_ptr<Pawn> BoardSnapshot::readPawn(Registry& registry, SnapshotReader& reader, uint32_t& parent) {
+	const Atom type = reader.readAtom();
+	const Atom name = reader.readAtom();
+	parent = reader.read<uint32_t>();
+	const auto flags = reader.read<uint8_t>();
+	const auto priority = reader.read<uint8_t>();
+
+	const auto factory = registry.pawns.find(type);
+
+	if (reader.isFailed() || factory == registry.pawns.end()) {
+		out::error("Board snapshot contains unknown pawn type '%s'!", type.str().c_str());
+		return nullptr;
+	}
+
+	std::shared_ptr<Pawn> pawn = factory->second.factory();
+	pawn->setName(name);
+	pawn->setThreadSafe(flags & THREAD_SAFE);
+	pawn->setUpdatePriority(static_cast<UpdatePriority>(priority));
+
+	if (flags & SPATIAL) {
+		const auto position = reader.read<glm::vec3>();
+		const auto rotation = reader.read<glm::vec4>();
+		const auto scale = reader.read<glm::vec3>();
+		const auto velocity = reader.read<glm::vec3>();
+		const auto angular_velocity = reader.read<glm::vec3>();
+
+		if (auto* spatial = dynamic_cast<SpatialPawn*>(pawn.get())) {
+			spatial->setPosition(position);
+			// stored as (w, x, y, z), the same order the quaternion constructor takes
+			spatial->setRotation(glm::quat {rotation.x, rotation.y, rotation.z, rotation.w});
+			spatial->setScale(scale);
+			spatial->setVelocity(velocity);
+			spatial->setAngularVelocity(angular_velocity);
+		}
+	}
+
+	const uint32_t count = reader.read<uint32_t>();
+
+	for (uint32_t i = 0; i < count && !reader.isFailed(); i ++) {
+		const Atom component = reader.readAtom();
+		SnapshotReader payload = reader.slice(reader.read<uint32_t>());
+
+		const auto loader = registry.components.find(component);
+
+		if (loader == registry.components.end()) {
+			out::warn("Skipping unknown component type '%s' in board snapshot", component.str().c_str());
+			continue;
+		}
+
+		if (!loader->second.loader(*pawn, payload) || payload.isFailed()) {
+			out::error("Failed to load component '%s' of pawn '%s' from board snapshot!", component.str().c_str(), pawn->getName().c_str());
+			return nullptr;
+		}
+	}
+
+	return pawn;
+}
+
+std::vector<uint8_t> BoardSnapshot::serialize(Board& board) {
+	SnapshotWriter body;
+
+	uint32_t pawns = 0;
+	uint32_t components = 0;
+
+	// depth-first order, parents are always written before their children, index 0 is the root pawn
+	std::vector<std::pair<Pawn*, uint32_t>> stack;
+	auto pushChildren = [&] (Pawn* pawn, uint32_t index) {
+		std::vector<std::shared_ptr<Pawn>>& children = pawn->getChildren();
+
+		for (auto it = children.rbegin(); it != children.rend(); ++ it) {
+			stack.emplace_back(it->get(), index);
+		}
+	};
+
+	pushChildren(board.getTree().getRoot().get(), 0);
+
+	while (!stack.empty()) {
+		auto [pawn, parent] = stack.back();
+		stack.pop_back();
+
+		if (pawn->getState() == PawnState::REMOVED) {
+			continue;
+		}
+
+		const PawnType* type = findPawnType(*pawn);
+
+		if (type == nullptr) {
+			out::warn("Skipping pawn '%s' of unregistered type in board snapshot", pawn->getName().c_str());
+			continue;
+		}
+
+		writePawn(*pawn, *type, parent, body, components);
+		pushChildren(pawn, ++ pawns);
+	}
+
+	SnapshotWriter header;
+	header.write<uint32_t>(MAGIC);
+	header.write<uint32_t>(VERSION);
+	header.write<uint32_t>(pawns);
+	header.write<uint32_t>(components);
+	header.write<uint32_t>(body.strings.size());
+
+	for (Atom string : body.strings) {
+		header.writeString(string.str());
+	}
+
+	header.bytes.insert(header.bytes.end(), body.bytes.begin(), body.bytes.end());
+	return std::move(header.bytes);
+}
+
+bool BoardSnapshot::deserialize(Board& board, const uint8_t* data, size_t size) {
+	Registry& types = registry();
+	SnapshotReader reader {data, size, nullptr};
+
+	const uint32_t magic = reader.read<uint32_t>();
+	const uint32_t version = reader.read<uint32_t>();
+
+	if (reader.isFailed() || magic != MAGIC) {
+		out::error("Invalid board snapshot header!");
+		return false;
+	}
+
+	if (version != VERSION) {
+		out::error("Unsupported board snapshot version %d, expected %d!", version, VERSION);
+		return false;
+	}
+
+	const uint32_t pawn_count = reader.read<uint32_t>();
+	const uint32_t component_count = reader.read<uint32_t>();
+	const uint32_t string_count = reader.read<uint32_t>();
+
+	// intern all the names once, records refer to them by index
+	std::vector<Atom> strings;
+	strings.reserve(std::min<size_t>(string_count, size));
+
+	for (uint32_t i = 0; i < string_count && !reader.isFailed(); i ++) {
+		strings.push_back(Atom::of(reader.readString()));
+	}
+
+	reader.strings = &strings;
+
+	// build the whole hierarchy detached, so that a broken snapshot leaves the board unchanged
+	std::vector<std::shared_ptr<Pawn>> pawns;
+	std::vector<std::shared_ptr<Pawn>> top;
+	pawns.reserve(std::min<size_t>(pawn_count, size));
+
+	for (uint32_t i = 0; i < pawn_count; i ++) {
+		uint32_t parent = 0;
+		std::shared_ptr<Pawn> pawn = readPawn(types, reader, parent);
+
+		if (!pawn || reader.isFailed() || parent > pawns.size()) {
+			out::error("Board snapshot is corrupted, failed to read pawn %d of %d!", i, pawn_count);
+			return false;
+		}
+
+		if (parent == 0) {
+			top.push_back(pawn);
+		} else {
+			pawns[parent - 1]->addChild(pawn);
+		}
+
+		pawns.push_back(std::move(pawn));
+	}
+
+	board.getTree().reserve(pawn_count, component_count);
+
+	for (const std::shared_ptr<Pawn>& pawn : top) {
+		board.addPawnToRoot(pawn);
+	}
+
+	return true;
+}
+
+bool BoardSnapshot::save(Board& board, const std::string& path) {
+	const std::vector<uint8_t> bytes = serialize(board);
+
+	file::createPathDirectories(path);
+	std::ofstream file {path, std::ios::binary | std::ios::trunc};
+	file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+	if (!file) {
+		out::error("Failed to write board snapshot '%s'!", path.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool BoardSnapshot::load(Board& board, const std::string& path) {
+	MappedFile file;
+
+	if (!file.open(path)) {
+		out::error("Failed to open board snapshot '%s'!", path.c_str());
+		return false;
+	}
+
+	return deserialize(board, file.data(), file.size());
+}
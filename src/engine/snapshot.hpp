@@ -0,0 +1,256 @@
+#pragma once
+#include "external.hpp"
+#include "entity/pawn.hpp"
+#include "shared/atom.hpp"
+#include "shared/flat.hpp"
+#include <typeindex>
+#include <cstring>
+
+class Board;
+
+/**
+ * Appends values to a board snapshot, values are stored in the native byte order
+ */
+class SnapshotWriter {
+protected:
+	friend class BoardSnapshot;
+	friend class Prefab;
+
+	std::vector<uint8_t> bytes;
+	FlatMap<Atom, uint32_t> string_map;
+	std::vector<Atom> strings;
+
+public:
+	/**
+	 * appends raw bytes of the value
+	 */
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	void write(const T& value) {
+		const auto* begin = reinterpret_cast<const uint8_t*>(&value);
+		bytes.insert(bytes.end(), begin, begin + sizeof(T));
+	}
+
+	/**
+	 * appends the element count followed by raw bytes of all the elements
+	 */
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	void writeArray(const std::vector<T>& values) {
+		write<uint32_t>(values.size());
+		const auto* begin = reinterpret_cast<const uint8_t*>(values.data());
+		bytes.insert(bytes.end(), begin, begin + values.size() * sizeof(T));
+	}
+
+	/**
+	 * appends the string as an index into the string table, each distinct string is stored in the snapshot once
+	 */
+	void writeAtom(Atom atom);
+
+	/**
+	 * appends the string inline
+	 */
+	void writeString(std::string_view string);
+};
+
+/**
+ * Reads values from a board snapshot, reading past the end marks the reader as failed and returns zeroed values
+ */
+class SnapshotReader {
+protected:
+	friend class BoardSnapshot;
+
+	const uint8_t* cursor;
+	const uint8_t* end;
+	const std::vector<Atom>* strings;
+	bool failed;
+
+	/**
+	 * returns pointer to the next size bytes and skips them, or nullptr if there are not enough bytes left
+	 */
+	const uint8_t* take(size_t size);
+
+public:
+	SnapshotReader(const uint8_t* data, size_t size, const std::vector<Atom>* strings);
+
+	/**
+	 * reads raw bytes of the value
+	 */
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	T read() {
+		T value {};
+
+		if (const uint8_t* bytes = take(sizeof(T))) {
+			std::memcpy(&value, bytes, sizeof(T));
+		}
+
+		return value;
+	}
+
+	/**
+	 * reads an array written with SnapshotWriter::writeArray()
+	 */
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	std::vector<T> readArray() {
+		const uint32_t count = read<uint32_t>();
+
+		// check the size first, so that a corrupted count can't trigger a huge allocation
+		if (static_cast<size_t>(end - cursor) / sizeof(T) < count) {
+			failed = true;
+			return {};
+		}
+
+		std::vector<T> values(count);
+
+		if (count > 0) {
+			std::memcpy(values.data(), take(count * sizeof(T)), count * sizeof(T));
+		}
+
+		return values;
+	}
+
+	/**
+	 * reads a string written with SnapshotWriter::writeAtom()
+	 */
+	Atom readAtom();
+
+	/**
+	 * reads a string written with SnapshotWriter::writeString(), the view points into the snapshot data
+	 */
+	std::string_view readString();
+
+	/**
+	 * returns a reader of the next size bytes and skips them in this reader
+	 */
+	SnapshotReader slice(size_t size);
+
+	/**
+	 * returns true if the data ended before all the values were read
+	 */
+	bool isFailed() const;
+};
+
+/**
+ * Versioned binary snapshot of the pawn hierarchy of a board, with transforms, component parameters and asset
+ * references, pawns are stored in the depth-first order so that a board is recreated in one pass, only pawn and
+ * component types registered with registerPawn() and registerComponent() are saved, other components are skipped
+ */
+class BoardSnapshot {
+public:
+	/// "CLBS" in little-endian, a snapshot saved with a different byte order fails this check
+	static constexpr uint32_t MAGIC = 0x53424c43;
+	static constexpr uint32_t VERSION = 1;
+
+	using PawnFactory = std::function<std::shared_ptr<Pawn>()>;
+	using ComponentSaver = std::function<void(Component&, SnapshotWriter&)>;
+	using ComponentLoader = std::function<bool(Pawn&, SnapshotReader&)>;
+
+protected:
+	friend class Prefab;
+
+	enum PawnFlags : uint8_t {
+		THREAD_SAFE = 0b01,
+		SPATIAL = 0b10
+	};
+
+	struct PawnType {
+		Atom name;
+		PawnFactory factory;
+		std::function<void(size_t)> reserve;
+	};
+
+	struct ComponentType {
+		Atom name;
+		ComponentSaver saver;
+		ComponentLoader loader;
+		std::function<void(size_t)> reserve;
+	};
+
+	/// types are stored in node based maps, so pointers to them stay valid
+	struct Registry {
+		std::unordered_map<Atom, PawnType> pawns;
+		std::unordered_map<std::type_index, PawnType*> pawns_by_type;
+		std::unordered_map<Atom, ComponentType> components;
+		std::unordered_map<std::type_index, ComponentType*> components_by_type;
+	};
+
+	/**
+	 * returns the type registry, engine pawns and components are registered on first use
+	 */
+	static Registry& registry();
+
+	/**
+	 * returns the registered type of the pawn, or nullptr if its type was not registered
+	 */
+	static PawnType* findPawnType(const Pawn& pawn);
+
+	/**
+	 * returns the registered type of the component, or nullptr if its type was not registered
+	 */
+	static ComponentType* findComponentType(const Component& component);
+
+	static void writePawn(Pawn& pawn, const PawnType& type, uint32_t parent, SnapshotWriter& writer, uint32_t& components);
+
+	static std::shared_ptr<Pawn> readPawn(Registry& registry, SnapshotReader& reader, uint32_t& parent);
+
+public:
+	/**
+	 * registers a pawn type under a name that is stored in the snapshots, should be called at startup
+	 */
+	template<DerivedTrait<Pawn> T>
+	static void registerPawn(std::string_view name) {
+		Registry& types = registry();
+		const Atom atom = Atom::of(name);
+
+		PawnType& type = types.pawns[atom];
+		type.name = atom;
+		type.factory = [] () -> std::shared_ptr<Pawn> {
+			return makePawn<T>();
+		};
+		type.reserve = [] (size_t count) {
+			SlabAllocator<T>::reserve(count);
+		};
+
+		types.pawns_by_type[typeid(T)] = &type;
+	}
+
+	/**
+	 * registers a component type under a name that is stored in the snapshots, the loader creates the component
+	 * on the given pawn and returns false if it can't be attached to it, should be called at startup
+	 */
+	template<DerivedTrait<Component> T>
+	static void registerComponent(std::string_view name, const std::function<void(T&, SnapshotWriter&)>& saver, const ComponentLoader& loader) {
+		Registry& types = registry();
+		const Atom atom = Atom::of(name);
+
+		ComponentType& type = types.components[atom];
+		type.name = atom;
+		type.saver = [saver] (Component& component, SnapshotWriter& writer) {
+			saver(static_cast<T&>(component), writer);
+		};
+		type.loader = loader;
+		type.reserve = [] (size_t count) {
+			SlabAllocator<T>::reserve(count);
+		};
+
+		types.components_by_type[typeid(T)] = &type;
+	}
+
+	/**
+	 * returns snapshot of all the pawns of the board, the same board state always gives the same bytes
+	 */
+	static std::vector<uint8_t> serialize(Board& board);
+
+	/**
+	 * adds all the pawns from the snapshot to the board, returns false and leaves the board unchanged if the snapshot is invalid
+	 */
+	static bool deserialize(Board& board, const uint8_t* data, size_t size);
+
+	/**
+	 * saves snapshot of the board into a file, returns false if the file could not be written
+	 */
+	static bool save(Board& board, const std::string& path);
+
+	/**
+	 * memory maps the snapshot file and adds all its pawns to the board, returns false if the file could not be loaded
+	 */
+	static bool load(Board& board, const std::string& path);
+};
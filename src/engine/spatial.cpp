@@ -0,0 +1,231 @@
+#include "spatial.hpp"
+#include "entity/pawns/spatialPawn.hpp"
+
+/*
+ * SpatialIndex
+ */
+
+static constexpr int CELL_LIMIT = 1 << 20;
+
+SpatialIndex::SpatialIndex(const float cell_size) {
+	this->cell_size = cell_size;
+	this->count = 0;
+}
+
+glm::ivec3 SpatialIndex::cellOf(const glm::vec3 position) const {
+	auto axis = [this] (float value) {
+		return (int) std::clamp(std::floor(value / cell_size), (float) -CELL_LIMIT, (float) (CELL_LIMIT - 1));
+	};
+
+	return {axis(position.x), axis(position.y), axis(position.z)};
+}
+
+uint64_t SpatialIndex::keyOf(const glm::ivec3 cell) {
+	const uint64_t x = (uint64_t) (cell.x + CELL_LIMIT);
+	const uint64_t y = (uint64_t) (cell.y + CELL_LIMIT);
+	const uint64_t z = (uint64_t) (cell.z + CELL_LIMIT);
+
+	return x | (y << 21) | (z << 42);
+}
+
+template<typename F>
+void SpatialIndex::forEachInCells(const glm::vec3 min, const glm::vec3 max, F function) {
+	const glm::ivec3 low = cellOf(min);
+	const glm::ivec3 high = cellOf(max);
+	const int64_t volume = int64_t(high.x - low.x + 1) * int64_t(high.y - low.y + 1) * int64_t(high.z - low.z + 1);
+
+	// for large boxes it's cheaper to just go over all the occupied cells
+	if (volume > (int64_t) cells.size()) {
+		cells.forEach([&] (uint64_t key, std::vector<SpatialPawn*>& pawns) {
+			for (SpatialPawn* pawn : pawns) {
+				function(pawn);
+			}
+		});
+
+		return;
+	}
+
+	for (int x = low.x; x <= high.x; x ++) {
+		for (int y = low.y; y <= high.y; y ++) {
+			for (int z = low.z; z <= high.z; z ++) {
+				if (std::vector<SpatialPawn*>* pawns = cells.find(keyOf({x, y, z}))) {
+					for (SpatialPawn* pawn : *pawns) {
+						function(pawn);
+					}
+				}
+			}
+		}
+	}
+}
+
+void SpatialIndex::collectShell(const glm::ivec3 center, const int distance, std::vector<SpatialPawn*>& result) {
+	auto collect = [&] (int x, int y, int z) {
+		if (std::vector<SpatialPawn*>* pawns = cells.find(keyOf({center.x + x, center.y + y, center.z + z}))) {
+			result.insert(result.end(), pawns->begin(), pawns->end());
+		}
+	};
+
+	if (distance == 0) {
+		collect(0, 0, 0);
+		return;
+	}
+
+	for (int x = -distance; x <= distance; x ++) {
+		for (int y = -distance; y <= distance; y ++) {
+
+			// on the side faces of the shell take the whole column, otherwise only its two ends
+			if (std::abs(x) == distance || std::abs(y) == distance) {
+				for (int z = -distance; z <= distance; z ++) {
+					collect(x, y, z);
+				}
+			} else {
+				collect(x, y, -distance);
+				collect(x, y, distance);
+			}
+		}
+	}
+}
+
+void SpatialIndex::update(SpatialPawn* pawn) {
+	const uint64_t key = keyOf(cellOf(pawn->getWorldPosition()));
+
+	if (pawn->spatial_indexed) {
+		if (pawn->spatial_cell == key) {
+			return;
+		}
+
+		remove(pawn);
+	}
+
+	std::vector<SpatialPawn*>& pawns = cells[key];
+	pawn->spatial_cell = key;
+	pawn->spatial_slot = pawns.size();
+	pawn->spatial_indexed = true;
+	pawns.push_back(pawn);
+
+	count ++;
+}
+
+void SpatialIndex::remove(SpatialPawn* pawn) {
+	if (!pawn->spatial_indexed) {
+		return;
+	}
+
+	pawn->spatial_indexed = false;
+	std::vector<SpatialPawn*>* pawns = cells.find(pawn->spatial_cell);
+	const size_t slot = pawn->spatial_slot;
+
+	// the pawn was indexed by a different index
+	if (pawns == nullptr || slot >= pawns->size() || (*pawns)[slot] != pawn) {
+		return;
+	}
+
+	if (slot != pawns->size() - 1) {
+		(*pawns)[slot] = pawns->back();
+		(*pawns)[slot]->spatial_slot = slot;
+	}
+
+	pawns->pop_back();
+
+	if (pawns->empty()) {
+		cells.erase(pawn->spatial_cell);
+	}
+
+	count --;
+}
+
+void SpatialIndex::reset(const float cell_size) {
+	cells.forEach([] (uint64_t key, std::vector<SpatialPawn*>& pawns) {
+		for (SpatialPawn* pawn : pawns) {
+			pawn->spatial_indexed = false;
+		}
+	});
+
+	cells.clear();
+	count = 0;
+	this->cell_size = cell_size;
+}
+
+size_t SpatialIndex::size() const {
+	return count;
+}
+
+void SpatialIndex::findInRadius(const glm::vec3 center, const float radius, std::vector<SpatialPawn*>& result) {
+	const float radius2 = radius * radius;
+
+	forEachInCells(center - glm::vec3(radius), center + glm::vec3(radius), [&] (SpatialPawn* pawn) {
+		if (glm::length2(pawn->getWorldPosition() - center) <= radius2) {
+			result.push_back(pawn);
+		}
+	});
+}
+
+void SpatialIndex::findInBox(const glm::vec3 min, const glm::vec3 max, std::vector<SpatialPawn*>& result) {
+	forEachInCells(min, max, [&] (SpatialPawn* pawn) {
+		const glm::vec3 position = pawn->getWorldPosition();
+
+		const bool inside = position.x >= min.x && position.y >= min.y && position.z >= min.z
+			&& position.x <= max.x && position.y <= max.y && position.z <= max.z;
+
+		if (inside) {
+			result.push_back(pawn);
+		}
+	});
+}
+
+void SpatialIndex::findNearest(const glm::vec3 center, const size_t k, std::vector<SpatialPawn*>& result) {
+	if (k == 0 || count == 0) {
+		return;
+	}
+
+	const glm::ivec3 center_cell = cellOf(center);
+	std::vector<SpatialPawn*> candidates;
+
+	// grow the searched cube one shell of cells at a time, after a shell at distance d is collected
+	// all the pawns closer than d cells are known, so the search can stop once the k-th best is that close
+	for (int distance = 0; candidates.size() < count; distance ++) {
+		const int64_t side = 2 * distance + 1;
+
+		if (side * side * side > (int64_t) cells.size()) {
+			candidates.clear();
+
+			cells.forEach([&] (uint64_t key, std::vector<SpatialPawn*>& pawns) {
+				candidates.insert(candidates.end(), pawns.begin(), pawns.end());
+			});
+
+			break;
+		}
+
+		collectShell(center_cell, distance, candidates);
+
+		if (candidates.size() >= k) {
+			auto closer = [center] (SpatialPawn* a, SpatialPawn* b) {
+				return glm::length2(a->getWorldPosition() - center) < glm::length2(b->getWorldPosition() - center);
+			};
+
+			std::nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end(), closer);
+
+			const float covered = distance * cell_size;
+			if (glm::length2(candidates[k - 1]->getWorldPosition() - center) <= covered * covered) {
+				break;
+			}
+		}
+	}
+
+	const size_t found = std::min(k, candidates.size());
+
+	std::partial_sort(candidates.begin(), candidates.begin() + found, candidates.end(), [center] (SpatialPawn* a, SpatialPawn* b) {
+		return glm::length2(a->getWorldPosition() - center) < glm::length2(b->getWorldPosition() - center);
+	});
+
+	result.insert(result.end(), candidates.begin(), candidates.begin() + found);
+}
+
+void SpatialIndex::findInRadius(const std::vector<glm::vec3>& centers, const float radius, std::vector<std::vector<SpatialPawn*>>& results) {
+	results.resize(centers.size());
+
+	for (size_t i = 0; i < centers.size(); i ++) {
+		results[i].clear();
+		findInRadius(centers[i], radius, results[i]);
+	}
+}
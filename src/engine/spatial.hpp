@@ -0,0 +1,82 @@
+#pragma once
+#include "external.hpp"
+#include "shared/flat.hpp"
+
+class SpatialPawn;
+
+/**
+ * Uniform hash grid over world positions of SpatialPawns, only the occupied cells are stored,
+ * pawns are moved between cells incrementally when their transform changes, see PawnTree::flushTransforms()
+ */
+class SpatialIndex {
+protected:
+	float cell_size;
+	size_t count;
+	FlatMap<uint64_t, std::vector<SpatialPawn*>> cells;
+
+	/**
+	 * returns integer coordinates of the cell containing the position
+	 */
+	glm::ivec3 cellOf(glm::vec3 position) const;
+
+	/**
+	 * packs integer cell coordinates into a single key
+	 */
+	static uint64_t keyOf(glm::ivec3 cell);
+
+	/**
+	 * calls the function for every pawn in the cells overlapping the box, iterates all
+	 * occupied cells instead if that would be cheaper
+	 */
+	template<typename F>
+	void forEachInCells(glm::vec3 min, glm::vec3 max, F function);
+
+	/**
+	 * appends all pawns from the cells at the given chebyshev distance from the center cell
+	 */
+	void collectShell(glm::ivec3 center, int distance, std::vector<SpatialPawn*>& result);
+
+public:
+	SpatialIndex(float cell_size = 8.0f);
+
+	/**
+	 * inserts the pawn or moves it to the cell of its current world position
+	 */
+	void update(SpatialPawn* pawn);
+
+	/**
+	 * removes the pawn from the index, does nothing if it isn't a part of it
+	 */
+	void remove(SpatialPawn* pawn);
+
+	/**
+	 * removes all the pawns and changes the cell size, cells should be a few times larger than typical query radius
+	 */
+	void reset(float cell_size);
+
+	/**
+	 * returns number of indexed pawns
+	 */
+	size_t size() const;
+
+	/**
+	 * appends all pawns within the radius of the center to the result
+	 */
+	void findInRadius(glm::vec3 center, float radius, std::vector<SpatialPawn*>& result);
+
+	/**
+	 * appends all pawns inside the axis aligned box to the result
+	 */
+	void findInBox(glm::vec3 min, glm::vec3 max, std::vector<SpatialPawn*>& result);
+
+	/**
+	 * appends up to k pawns closest to the center to the result, sorted by distance
+	 */
+	void findNearest(glm::vec3 center, size_t k, std::vector<SpatialPawn*>& result);
+
+	/**
+	 * performs one radius query per center, results[i] is replaced with the result of centers[i],
+	 * reusing the allocated vectors, so repeating the batch every frame doesn't allocate
+	 */
+	void findInRadius(const std::vector<glm::vec3>& centers, float radius, std::vector<std::vector<SpatialPawn*>>& results);
+};
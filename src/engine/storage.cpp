@@ -0,0 +1,101 @@
+#include "storage.hpp"
+
+/*
+ * ComponentArray
+ */
+
+ComponentArray::ComponentArray(ComponentSlot::Type slot) {
+	this->slot = slot;
+	this->iterations = 0;
+	this->holes = false;
+}
+
+ComponentArray::~ComponentArray() {
+	clear();
+}
+
+void ComponentArray::insert(Component* component) {
+	ComponentSlot& entry = component->slots[slot];
+
+	if (entry.array == this) {
+		return;
+	}
+
+	if (entry.array != nullptr) {
+		entry.array->remove(component);
+	}
+
+	entry.array = this;
+	entry.index = dense.size();
+	dense.push_back(component);
+}
+
+void ComponentArray::remove(Component* component) {
+	ComponentSlot& entry = component->slots[slot];
+
+	if (entry.array != this) {
+		return;
+	}
+
+	// swapping would move a component that the iteration hasn't reached yet behind it
+	if (iterations > 0) {
+		dense[entry.index] = nullptr;
+		holes = true;
+	} else {
+		Component* last = dense.back();
+		dense[entry.index] = last;
+		last->slots[slot].index = entry.index;
+		dense.pop_back();
+	}
+
+	entry.array = nullptr;
+	entry.index = 0;
+}
+
+void ComponentArray::removeFromAll(Component* component) {
+	for (ComponentSlot& entry: component->slots) {
+		if (entry.array != nullptr) {
+			entry.array->remove(component);
+		}
+	}
+}
+
+void ComponentArray::clear() {
+	for (Component* component: dense) {
+		if (component != nullptr) {
+			component->slots[slot].array = nullptr;
+			component->slots[slot].index = 0;
+		}
+	}
+
+	dense.clear();
+	holes = false;
+}
+
+void ComponentArray::beginIteration() {
+	iterations ++;
+}
+
+void ComponentArray::endIteration() {
+	iterations --;
+
+	if (iterations > 0 || !holes) {
+		return;
+	}
+
+	size_t next = 0;
+
+	for (Component* component : dense) {
+		if (component != nullptr) {
+			component->slots[slot].index = next;
+			dense[next ++] = component;
+		}
+	}
+
+	dense.resize(next);
+	holes = false;
+}
+
+size_t ComponentArray::size() const {
+	return dense.size();
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "entity/component.hpp"
+
+/**
+ * Dense, unordered array of components, components are removed by swapping
+ * with the last element so the array never contains holes (except during an iteration,
+ * see beginIteration()). Each array uses one of the component's slots to remember the position
+ * of the component, so a component can be a part of one array per slot type at the same time
+ */
+class ComponentArray {
+protected:
+	ComponentSlot::Type slot;
+	std::vector<Component*> dense;
+	uint32_t iterations;
+	bool holes;
+
+public:
+	ComponentArray(ComponentSlot::Type slot);
+	ComponentArray(const ComponentArray& other) = delete;
+
+	virtual ~ComponentArray();
+
+	/**
+	 * adds a component to the array, if the component was in other array using the same slot it is removed from it first
+	 */
+	void insert(Component* component);
+
+	/**
+	 * removes a component from the array, does nothing if the component is not in this array
+	 */
+	void remove(Component* component);
+
+	/**
+	 * removes a component from all the arrays it is a part of
+	 */
+	static void removeFromAll(Component* component);
+
+	/**
+	 * removes all the components from the array
+	 */
+	void clear();
+
+	/**
+	 * starts an iteration over the array, until it ends removed components leave a null hole in place, so that
+	 * components don't move while the array is being iterated, components inserted meanwhile are appended at the end
+	 */
+	void beginIteration();
+
+	/**
+	 * ends the iteration started with beginIteration(), the holes are removed once the last iteration ends
+	 */
+	void endIteration();
+
+	/**
+	 * returns number of components in the array
+	 */
+	size_t size() const;
+
+	/**
+	 * returns component at given position, the order of components is unspecified, can be null during an iteration
+	 */
+	Component* operator[](size_t index) const {
+		return dense[index];
+	}
+};
@@ -26,7 +26,9 @@
 #include <sstream>
 #include <variant>
 #include <array>
+#include <bit>
 #include <regex>
+#include <memory_resource>
 
 // GLFW
 #define GLFW_INCLUDE_VULKAN
@@ -6,6 +6,7 @@
 #include <gui/widget/panel.hpp>
 #include <gui/widget/root.hpp>
 #include <gui/widget/text.hpp>
+#include <shared/arena.hpp>
 #include <shared/args.hpp>
 #include <shared/logger.hpp>
 #include "sound/sound.hpp"
@@ -233,6 +234,69 @@ static void entry(Args& args) {
 	Models::terminate();
 }
 
+static void headless(Args& args) {
+	Headless::setEnabled(true);
+
+	int frames = 1000;
+	int pawns = 1000;
+
+	// std::stoi() throws on values that are not numbers or don't fit in an int
+	try {
+		if (args.has("--frames")) frames = std::stoi(args.get("--frames"));
+		if (args.has("--pawns")) pawns = std::stoi(args.get("--pawns"));
+	} catch (std::exception& exception) {
+		out::error("Invalid headless run, expected numeric frame and pawn counts!");
+		return;
+	}
+
+	if (frames <= 0 || pawns < 0) {
+		out::error("Invalid headless run, expected a positive frame count and a non-negative pawn count!");
+		return;
+	}
+
+	BoardManager manager;
+	manager.setGravity(glm::vec3(0, -10, 0));
+
+	std::shared_ptr<Board> sp = manager.getCurrentBoard().lock();
+
+	// same kind of pawns as the windowed demo, render and sound components bind to nothing
+	for (int i = 0; i < pawns; i ++) {
+		auto cube = makePawn<SpatialPawn>();
+		cube->setPosition(glm::vec3((i % 32) * 3, 1, (i / 32) * 3));
+		cube->createComponent<RenderComponent>(Models::CUBE);
+		cube->createComponent<MatrixAnimation>(MatrixAnimation::ROTATE);
+		sp->addPawnToRoot(cube);
+	}
+
+	out::info("Running %d headless frames with %d pawns...", frames, pawns);
+	Timer timer;
+
+	for (int i = 0; i < frames; i ++) {
+		manager.updateCycle();
+	}
+
+	const double elapsed = timer.milliseconds();
+	out::info("Average frame time: %fms (%d frames in %fms)", elapsed / frames, frames, elapsed);
+	out::info("%s", manager.getFrameGraph().getReport().c_str());
+
+	const PoolStatistics statistics = manager.getTaskPool().getStatistics();
+	out::info("Task pool: %d tasks, %d stolen, average utilization %f", (int) statistics.getExecuted(), (int) statistics.getStolen(), statistics.getUtilization());
+
+	for (const ArenaStatistics& arena : FrameArena::getAllStatistics()) {
+		out::info("Frame arena of %s: peak %d bytes, %d bytes in %d chunk allocations over %d frames", arena.name.c_str(), (int) arena.peak, (int) arena.capacity, (int) arena.allocations, (int) arena.frames);
+	}
+
+	if (args.has("--pool-stats")) {
+		const std::string path = args.get("--pool-stats");
+		std::ofstream file {path, std::ios::trunc};
+		file << statistics.toJson();
+
+		if (!file) {
+			out::error("Failed to write task pool statistics '%s'!", path.c_str());
+		}
+	}
+}
+
 int main(int argc, const char* argv[]) {
 	Args args{argc, argv};
 
@@ -243,6 +307,11 @@ int main(int argc, const char* argv[]) {
 		out::logger.setLogLevelMask(Logger::LEVEL_VERBOSE);
 	}
 
+	if (args.has("--headless")) {
+		headless(args);
+		return 0;
+	}
+
 	entry(args);
 
 	return 0;
@@ -2,6 +2,7 @@
 #include "engine/board.hpp"
 #include "engine/boardManager.hpp"
 #include "shared/math.hpp"
+#include "shared/arena.hpp"
 #include "physicsElement.hpp"
 #include "engine/entity/component/physics.hpp"
 
@@ -21,11 +22,11 @@ bool PhysicsEngine::initialCollisionCheck(PhysicsElement &a, PhysicsElement &b)
 	return (glm::length(a.position - b.position) <= a.sphere_collider_radius + b.sphere_collider_radius);
 }
 
-std::pair<bool, std::vector<SupportPoint> > PhysicsEngine::gilbertJohnsonKeerthi(PhysicsElement &a, PhysicsElement &b) {
+std::pair<bool, std::pmr::vector<SupportPoint> > PhysicsEngine::gilbertJohnsonKeerthi(PhysicsElement &a, PhysicsElement &b) {
 	//get direction by comparing relative position of objects
 	glm::vec3 direction = glm::normalize(b.position - a.position);
 	//get the 0th point of the simplex by getting the support point of the Minkowski difference in the above direction
-	std::vector<SupportPoint> simplex;
+	std::pmr::vector<SupportPoint> simplex {&FrameArena::current()};
     simplex.push_back(calculateSupportWithPoints(a, b, direction));
 	//get new direction as a vector pointing from 0th point of simplex to the origin
 	direction = glm::vec3(0, 0, 0) - simplex.at(0).point;
@@ -34,24 +35,24 @@ std::pair<bool, std::vector<SupportPoint> > PhysicsEngine::gilbertJohnsonKeerthi
         SupportPoint point = calculateSupportWithPoints(a, b, direction);
 		//if the new point does not pass the origin, the point is not valid, and so the collision didn't happen - return false
 		if (glm::dot(point.point, direction) < 0) {
-			return {false, simplex};
+			return {false, std::move(simplex)};
 		}
 		//point valid - append it to simplex
 		simplex.push_back(point);
 		//make sure the origin is in the simplex, if it is the collision happened - return true
 		//if it's not - update the simplex and continue
 		if (manageSimplex(simplex, direction)) {
-			return {true, simplex};
+			return {true, std::move(simplex)};
 		}
 	}
-	return {false, simplex};
+	return {false, std::move(simplex)};
 }
 
 glm::vec3 PhysicsEngine::calculateSupport(PhysicsElement &a, PhysicsElement &b, glm::vec3 &direction) {
 	return a.furthestPoint(direction) - b.furthestPoint(-direction);
 }
 
-bool PhysicsEngine::manageSimplex(std::vector<SupportPoint> &simplex, glm::vec3 &direction) {
+bool PhysicsEngine::manageSimplex(std::pmr::vector<SupportPoint> &simplex, glm::vec3 &direction) {
 	if (simplex.size() > 4) {
 		throw std::runtime_error{"Simplex has more than 4 vertexes!"};
 	}
@@ -64,7 +65,7 @@ bool PhysicsEngine::manageSimplex(std::vector<SupportPoint> &simplex, glm::vec3
 	return tetrahedronCase(simplex, direction);
 }
 
-bool PhysicsEngine::lineCase(std::vector<SupportPoint> &simplex, glm::vec3 &direction) {
+bool PhysicsEngine::lineCase(std::pmr::vector<SupportPoint> &simplex, glm::vec3 &direction) {
 	//vector pointing from the newest point to the origin
 	glm::vec3 ao = glm::vec3(0, 0, 0) - simplex.at(1).point;
 	//vector pointing from the newest point to the oldest
@@ -76,7 +77,7 @@ bool PhysicsEngine::lineCase(std::vector<SupportPoint> &simplex, glm::vec3 &dire
 	return false;
 }
 
-bool PhysicsEngine::planeCase(std::vector<SupportPoint> &simplex, glm::vec3 &direction) {
+bool PhysicsEngine::planeCase(std::pmr::vector<SupportPoint> &simplex, glm::vec3 &direction) {
 	//vector pointing from the newest point to the origin
 	glm::vec3 ao = glm::vec3(0, 0, 0) - simplex.at(2).point;
 
@@ -122,7 +123,7 @@ bool PhysicsEngine::planeCase(std::vector<SupportPoint> &simplex, glm::vec3 &dir
 	return false;
 }
 
-bool PhysicsEngine::tetrahedronCase(std::vector<SupportPoint> &simplex, glm::vec3 &direction) {
+bool PhysicsEngine::tetrahedronCase(std::pmr::vector<SupportPoint> &simplex, glm::vec3 &direction) {
 	//as in the cases above we start with defining vectors
 	glm::vec3 ao = glm::vec3(0, 0, 0) - simplex.at(3).point;
 
@@ -297,21 +298,21 @@ double_face_check:
 }
 
 std::pair<std::pair<float, glm::vec3>, glm::vec3> PhysicsEngine::expandingPolytope(
-	std::vector<SupportPoint> &simplex, PhysicsElement &a, PhysicsElement &b) {
+	std::pmr::vector<SupportPoint> &simplex, PhysicsElement &a, PhysicsElement &b) {
 	//create a copy of end simplex to be turned into a polytope, it may differ slightly from the original simplex,
 	//but the algorithm will work properly regardless - this is just an arbitrary starting point
-	std::vector<SupportPoint> polytope;
+	std::pmr::vector<SupportPoint> polytope {&FrameArena::current()};
 	for (auto p: simplex) {
 		//polytope.push_back(calculateSupportWithPoints(a, b, p));
         polytope.push_back(p);
 	}
 
-	std::vector<glm::ivec3> faces = {
+	std::pmr::vector<glm::ivec3> faces {{
 		{0, 1, 2},
 		{0, 3, 1},
 		{0, 2, 3},
 		{1, 3, 2}
-	};
+	}, &FrameArena::current()};
 
 	auto [normal_list, closest_face] = getFaceNormals(polytope, faces);
 
@@ -356,7 +357,7 @@ std::pair<std::pair<float, glm::vec3>, glm::vec3> PhysicsEngine::expandingPolyto
 			//
 			//We begin the process by finding which edges face the same direction and then check for the uniqueness
 			//of their edges
-			std::vector<std::pair<int, int> > unique_edges;
+			std::pmr::vector<std::pair<int, int> > unique_edges {&FrameArena::current()};
 
 			for (int i = 0; i < (int) normal_list.size(); i++) {
 				//check for direction
@@ -378,7 +379,7 @@ std::pair<std::pair<float, glm::vec3>, glm::vec3> PhysicsEngine::expandingPolyto
 			}
 
 			//now that we deleted the non-needed faces, we need to construct new ones that touch the new support point
-			std::vector<glm::ivec3> new_faces;
+			std::pmr::vector<glm::ivec3> new_faces {&FrameArena::current()};
 			for (auto [edge, edge2]: unique_edges) {
 				new_faces.emplace_back(edge, edge2, polytope.size());
 				//this is the part, where I am not sure whether the order remains clockwise
@@ -445,10 +446,10 @@ SupportPoint PhysicsEngine::calculateSupportWithPoints(PhysicsElement &a, Physic
 	return {a_point - b_point, a_point, b_point};
 }
 
-std::pair<std::vector<glm::vec4>, int> PhysicsEngine::getFaceNormals(std::vector<SupportPoint> &polytope,
-                                                                     std::vector<glm::ivec3> &faces) {
+std::pair<std::pmr::vector<glm::vec4>, int> PhysicsEngine::getFaceNormals(std::pmr::vector<SupportPoint> &polytope,
+                                                                     std::pmr::vector<glm::ivec3> &faces) {
 	//prepare variables needed for finding face normals and the closes face
-	std::vector<glm::vec4> normal_list;
+	std::pmr::vector<glm::vec4> normal_list {&FrameArena::current()};
 	int closest_face = 0;
 	float min_distance = INFINITY;
 
@@ -480,10 +481,10 @@ std::pair<std::vector<glm::vec4>, int> PhysicsEngine::getFaceNormals(std::vector
 		}
 	}
 
-	return {normal_list, closest_face};
+	return {std::move(normal_list), closest_face};
 }
 
-void PhysicsEngine::addUniqueEdge(std::vector<std::pair<int, int> > &edges, std::vector<glm::ivec3> faces, int face_num,
+void PhysicsEngine::addUniqueEdge(std::pmr::vector<std::pair<int, int> > &edges, const std::pmr::vector<glm::ivec3> &faces, int face_num,
                                   int a, int b) {
 	//create edge from 2 vertices given as a and b
 	auto edge = std::find(edges.begin(), edges.end(), std::make_pair(faces.at(face_num)[b], faces.at(face_num)[a]));
@@ -584,6 +585,9 @@ double PhysicsEngine::physicsUpdate() {
 		for (int j = i + 1; j < (int) elements.size(); j++) {
 			//initial, time efficient, but inaccurate collision detection
 			if (initialCollisionCheck(elements[i], elements[j])) {
+				//the temporaries of GJK and EPA are only needed for this pair, so give them back to the arena afterwards
+				FrameArena::Scope scope {FrameArena::current()};
+
 				//second, more time-consuming, but exact detection
 				auto [isColliding, simplex] = gilbertJohnsonKeerthi(elements[i], elements[j]);
 				if (isColliding) {
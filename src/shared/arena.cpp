@@ -0,0 +1,189 @@
+#include "arena.hpp"
+
+/*
+ * FrameArena::Scope
+ */
+
+FrameArena::Scope::Scope(FrameArena& arena)
+: arena(arena), marker(arena.mark()) {}
+
+FrameArena::Scope::~Scope() {
+	arena.rewind(marker);
+}
+
+/*
+ * FrameArena
+ */
+
+static size_t alignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+std::mutex& FrameArena::registryMutex() {
+	static std::mutex mutex;
+	return mutex;
+}
+
+std::vector<FrameArena*>& FrameArena::registry() {
+	static std::vector<FrameArena*> arenas;
+	return arenas;
+}
+
+void FrameArena::insert(size_t index, size_t size) {
+	unsigned char* data = static_cast<unsigned char*>(::operator new(size));
+	chunks.insert(chunks.begin() + index, Chunk {data, size});
+
+	capacity.fetch_add(size, std::memory_order_relaxed);
+	allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FrameArena::advance(size_t bytes, size_t alignment) {
+	const size_t required = bytes + alignment;
+
+	if (!chunks.empty()) {
+		before += chunks[chunk].size;
+		chunk ++;
+	}
+
+	offset = 0;
+
+	// the chunks after the current one are only there for reuse, so a bigger one can be placed before them
+	if (chunk == chunks.size() || chunks[chunk].size < required) {
+		insert(chunk, std::max(CHUNK_SIZE, alignUp(required, CHUNK_SIZE)));
+	}
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+	size_t start = 0;
+
+	if (!chunks.empty()) {
+		const uintptr_t base = reinterpret_cast<uintptr_t>(chunks[chunk].data);
+		start = alignUp(base + offset, alignment) - base;
+	}
+
+	if (chunks.empty() || start + bytes > chunks[chunk].size) {
+		advance(bytes, alignment);
+
+		const uintptr_t base = reinterpret_cast<uintptr_t>(chunks[chunk].data);
+		start = alignUp(base, alignment) - base;
+	}
+
+	offset = start + bytes;
+
+	const size_t used = before + offset;
+	if (used > peak.load(std::memory_order_relaxed)) {
+		peak.store(used, std::memory_order_relaxed);
+	}
+
+	return chunks[chunk].data + start;
+}
+
+void FrameArena::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+	unsigned char* bytes_pointer = static_cast<unsigned char*>(pointer);
+	unsigned char* data = chunks[chunk].data;
+
+	// only the most recent allocation can be given back, the rest is released by reset()
+	if (bytes_pointer >= data && bytes_pointer + bytes == data + offset) {
+		offset = bytes_pointer - data;
+	}
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+	return this == &other;
+}
+
+FrameArena::FrameArena(std::string name, size_t reserve)
+: name(std::move(name)), chunk(0), offset(0), before(0), last(0), peak(0), capacity(0), frames(0), allocations(0) {
+	if (reserve > 0) {
+		insert(0, reserve);
+	}
+
+	std::lock_guard lock {registryMutex()};
+	registry().push_back(this);
+}
+
+FrameArena::~FrameArena() {
+	{
+		std::lock_guard lock {registryMutex()};
+		std::erase(registry(), this);
+	}
+
+	for (Chunk& chunk : chunks) {
+		::operator delete(chunk.data);
+	}
+}
+
+void FrameArena::reset() {
+	last.store(getUsed(), std::memory_order_relaxed);
+	frames.fetch_add(1, std::memory_order_relaxed);
+
+	// a frame that needed more than one chunk will likely need it again, so merge them into one
+	if (chunks.size() > 1) {
+		const size_t total = capacity.load(std::memory_order_relaxed);
+
+		for (Chunk& chunk : chunks) {
+			::operator delete(chunk.data);
+		}
+
+		chunks.clear();
+		capacity.store(0, std::memory_order_relaxed);
+		insert(0, total);
+	}
+
+	chunk = 0;
+	offset = 0;
+	before = 0;
+}
+
+FrameArena::Marker FrameArena::mark() const {
+	return {chunk, offset};
+}
+
+void FrameArena::rewind(Marker marker) {
+	if (marker.chunk != chunk) {
+		before = 0;
+
+		for (size_t i = 0; i < marker.chunk; i ++) {
+			before += chunks[i].size;
+		}
+	}
+
+	chunk = marker.chunk;
+	offset = marker.offset;
+}
+
+size_t FrameArena::getUsed() const {
+	return before + offset;
+}
+
+ArenaStatistics FrameArena::getStatistics() const {
+	return {
+		name,
+		last.load(std::memory_order_relaxed),
+		peak.load(std::memory_order_relaxed),
+		capacity.load(std::memory_order_relaxed),
+		frames.load(std::memory_order_relaxed),
+		allocations.load(std::memory_order_relaxed)
+	};
+}
+
+FrameArena& FrameArena::current() {
+	thread_local FrameArena arena {[] () {
+		std::ostringstream name;
+		name << "thread " << std::this_thread::get_id();
+		return name.str();
+	}()};
+
+	return arena;
+}
+
+std::vector<ArenaStatistics> FrameArena::getAllStatistics() {
+	std::lock_guard lock {registryMutex()};
+	std::vector<ArenaStatistics> statistics;
+
+	for (FrameArena* arena : registry()) {
+		statistics.push_back(arena->getStatistics());
+	}
+
+	return statistics;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "external.hpp"
+
+/**
+ * Snapshot of the state of a single FrameArena
+ */
+struct ArenaStatistics {
+	std::string name;
+	size_t last;
+	size_t peak;
+	size_t capacity;
+	size_t frames;
+	size_t allocations;
+};
+
+/**
+ * Linear allocator for short-lived memory, allocation bumps an offset in the current chunk and
+ * deallocation does nothing (except for the most recent allocation which is rolled back so that growing
+ * containers don't waste space), all memory is reclaimed at once by reset(), the chunks are kept,
+ * so once the arena warms up it doesn't call the system allocator at all,
+ * the arena is a std::pmr::memory_resource, so pmr containers can opt into using it
+ */
+class FrameArena : public std::pmr::memory_resource {
+
+	public:
+
+		static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+		/**
+		 * Position in the arena, see mark() and rewind()
+		 */
+		struct Marker {
+			size_t chunk;
+			size_t offset;
+		};
+
+		/**
+		 * Rewinds the arena to the position it had when the scope was created,
+		 * used around units of work that can nest (like tasks executed while waiting)
+		 */
+		class Scope {
+
+			private:
+
+				FrameArena& arena;
+				Marker marker;
+
+			public:
+
+				Scope(FrameArena& arena);
+				Scope(const Scope&) = delete;
+				~Scope();
+
+		};
+
+	private:
+
+		struct Chunk {
+			unsigned char* data;
+			size_t size;
+		};
+
+		std::string name;
+		std::vector<Chunk> chunks;
+		size_t chunk;
+		size_t offset;
+
+		// sum of the sizes of the chunks before the current one, used for statistics
+		size_t before;
+
+		// written only by the owner, read by getStatistics() from any thread
+		std::atomic<size_t> last;
+		std::atomic<size_t> peak;
+		std::atomic<size_t> capacity;
+		std::atomic<size_t> frames;
+		std::atomic<size_t> allocations;
+
+		static std::mutex& registryMutex();
+		static std::vector<FrameArena*>& registry();
+
+		/// Move to the next chunk that can fit the allocation, allocates a new one if there is none
+		void advance(size_t bytes, size_t alignment);
+
+		/// Allocate a new chunk from the system and insert it at the given index
+		void insert(size_t index, size_t size);
+
+	protected:
+
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	public:
+
+		FrameArena(std::string name, size_t reserve = CHUNK_SIZE);
+		FrameArena(const FrameArena&) = delete;
+		~FrameArena() override;
+
+		/**
+		 * Releases all the allocations at once and starts the next frame, must
+		 * only be called by the owning thread when no arena memory is in use
+		 */
+		void reset();
+
+		/**
+		 * Returns the current position in the arena
+		 */
+		Marker mark() const;
+
+		/**
+		 * Releases everything allocated after the marker was taken
+		 */
+		void rewind(Marker marker);
+
+		/**
+		 * Returns the number of bytes currently allocated from the arena, can only be called by the owning thread
+		 */
+		size_t getUsed() const;
+
+		/**
+		 * Returns the usage statistics of this arena, can be called from any thread
+		 */
+		ArenaStatistics getStatistics() const;
+
+		/**
+		 * Returns the arena of the calling thread, the memory allocated from it is valid until
+		 * the end of the frame (on the main thread) or the end of the task (on pool threads)
+		 */
+		static FrameArena& current();
+
+		/**
+		 * Returns statistics of all arenas that exist in the program
+		 */
+		static std::vector<ArenaStatistics> getAllStatistics();
+
+};
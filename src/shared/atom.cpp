@@ -0,0 +1,93 @@
+#include "atom.hpp"
+
+/*
+ * Atom
+ */
+
+std::mutex& Atom::mutex() {
+	static std::mutex mutex;
+	return mutex;
+}
+
+std::unordered_map<std::string_view, uint32_t>& Atom::lookup() {
+
+	// the empty string is always the first atom, so that default constructed atoms need no lookup
+	static std::unordered_map<std::string_view, uint32_t> lookup = [] () {
+		std::string* storage = new std::string[CHUNK_SIZE];
+		chunks()[0].store(storage, std::memory_order_release);
+
+		return std::unordered_map<std::string_view, uint32_t> {{storage[0], 0}};
+	}();
+
+	return lookup;
+}
+
+std::atomic<std::string*>* Atom::chunks() {
+
+	// chunks are never moved, so str() can read interned strings without locking
+	static std::atomic<std::string*> chunks[CHUNK_COUNT] {};
+	return chunks;
+}
+
+Atom::Atom(uint32_t id)
+: id(id) {}
+
+Atom::Atom()
+: id(0) {}
+
+Atom Atom::of(std::string_view string) {
+	std::lock_guard lock {mutex()};
+	auto& map = lookup();
+
+	if (auto it = map.find(string); it != map.end()) {
+		return Atom {it->second};
+	}
+
+	const uint32_t next = map.size();
+	const uint32_t chunk = next >> CHUNK_BITS;
+
+	if (chunk >= CHUNK_COUNT) {
+		throw std::length_error {"Too many interned atoms!"};
+	}
+
+	std::string* storage = chunks()[chunk].load(std::memory_order_acquire);
+
+	if (storage == nullptr) {
+		storage = new std::string[CHUNK_SIZE];
+		chunks()[chunk].store(storage, std::memory_order_release);
+	}
+
+	std::string& interned = storage[next & (CHUNK_SIZE - 1)];
+	interned = string;
+	map.emplace(interned, next);
+
+	return Atom {next};
+}
+
+std::optional<Atom> Atom::find(std::string_view string) {
+	std::lock_guard lock {mutex()};
+	auto& map = lookup();
+
+	if (auto it = map.find(string); it != map.end()) {
+		return Atom {it->second};
+	}
+
+	return std::nullopt;
+}
+
+const std::string& Atom::str() const {
+	if (id == 0) {
+		static const std::string empty;
+		return empty;
+	}
+
+	return chunks()[id >> CHUNK_BITS].load(std::memory_order_acquire)[id & (CHUNK_SIZE - 1)];
+}
+
+uint32_t Atom::value() const {
+	return id;
+}
+
+bool Atom::empty() const {
+	return id == 0;
+}
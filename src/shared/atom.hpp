@@ -0,0 +1,68 @@
+#pragma once
+
+#include "external.hpp"
+#include <optional>
+
+/**
+ * Interned string, all atoms created from equal strings are equal and share one global copy of the
+ * string, so comparing and hashing an atom is as cheap as comparing and hashing an integer,
+ * interned strings are never freed, so only use atoms for a bounded set of names
+ */
+class Atom {
+
+	private:
+
+		static constexpr uint32_t CHUNK_BITS = 10;
+		static constexpr uint32_t CHUNK_SIZE = 1 << CHUNK_BITS;
+		static constexpr uint32_t CHUNK_COUNT = 4096;
+
+		uint32_t id;
+
+		explicit Atom(uint32_t id);
+
+		static std::mutex& mutex();
+		static std::unordered_map<std::string_view, uint32_t>& lookup();
+		static std::atomic<std::string*>* chunks();
+
+	public:
+
+		/// Creates an atom of an empty string
+		Atom();
+
+		/**
+		 * Returns the atom of the given string, interning it if it was not seen before
+		 */
+		static Atom of(std::string_view string);
+
+		/**
+		 * Returns the atom of the given string only if it was already interned, never allocates,
+		 * use this for lookups - a string that was never interned can't be a key of anything
+		 */
+		static std::optional<Atom> find(std::string_view string);
+
+		/**
+		 * Returns the interned string, the reference stays valid until the program exits
+		 */
+		const std::string& str() const;
+
+		/**
+		 * Returns the unique integer value of this atom
+		 */
+		uint32_t value() const;
+
+		/**
+		 * Returns true if this is the atom of an empty string
+		 */
+		bool empty() const;
+
+		bool operator==(const Atom& other) const = default;
+		auto operator<=>(const Atom& other) const = default;
+
+};
+
+template <>
+struct std::hash<Atom> {
+	size_t operator()(const Atom& atom) const noexcept {
+		return atom.value();
+	}
+};
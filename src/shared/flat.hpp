@@ -0,0 +1,177 @@
+#pragma once
+
+#include "external.hpp"
+
+/**
+ * Hash map with open addressing and linear probing, all entries are stored
+ * in one contiguous array so a lookup is usually a single cache miss,
+ * pointers to values are invalidated by insertions and removals
+ */
+template <typename K, typename V, typename H = std::hash<K>>
+class FlatMap {
+
+	private:
+
+		struct Entry {
+			K key;
+			V value;
+			bool used = false;
+		};
+
+		std::vector<Entry> entries;
+		size_t count = 0;
+
+		size_t mask() const {
+			return entries.size() - 1;
+		}
+
+		/// Spread the bits of the hash, so that integer keys with an identity hash don't cluster
+		static size_t mix(size_t hash) {
+			hash ^= hash >> 33;
+			hash *= 0xff51afd7ed558ccdULL;
+			hash ^= hash >> 33;
+			return hash;
+		}
+
+		size_t slot(const K& key) const {
+			return mix(H {}(key)) & mask();
+		}
+
+		/// Find the index of the entry with the given key, or of the free entry that ends its probe sequence
+		size_t probe(const K& key) const {
+			size_t index = slot(key);
+
+			while (entries[index].used && !(entries[index].key == key)) {
+				index = (index + 1) & mask();
+			}
+
+			return index;
+		}
+
+		void rehash(size_t capacity) {
+			std::vector<Entry> previous = std::move(entries);
+			entries = std::vector<Entry>(capacity);
+
+			for (Entry& entry : previous) {
+				if (entry.used) {
+					Entry& target = entries[probe(entry.key)];
+					target.key = std::move(entry.key);
+					target.value = std::move(entry.value);
+					target.used = true;
+				}
+			}
+		}
+
+	public:
+
+		/// Get pointer to the value with the given key, or nullptr if there is none
+		V* find(const K& key) {
+			if (count == 0) {
+				return nullptr;
+			}
+
+			Entry& entry = entries[probe(key)];
+			return entry.used ? &entry.value : nullptr;
+		}
+
+		/// Get pointer to the value with the given key, or nullptr if there is none
+		const V* find(const K& key) const {
+			return const_cast<FlatMap*>(this)->find(key);
+		}
+
+		/// Get the value with the given key, inserting a default constructed one if there is none
+		V& operator[](const K& key) {
+
+			// keep the load factor under 1/2, so that probe sequences stay short
+			if ((count + 1) * 2 > entries.size()) {
+				rehash(std::max<size_t>(16, entries.size() * 2));
+			}
+
+			Entry& entry = entries[probe(key)];
+
+			if (!entry.used) {
+				entry.key = key;
+				entry.value = V {};
+				entry.used = true;
+				count ++;
+			}
+
+			return entry.value;
+		}
+
+		/// Preallocate space for the given number of elements, so that inserting them doesn't rehash
+		void reserve(size_t capacity) {
+			size_t target = 16;
+
+			while (target < capacity * 2) {
+				target *= 2;
+			}
+
+			if (target > entries.size()) {
+				rehash(target);
+			}
+		}
+
+		/// Remove the value with the given key, returns false if there was none
+		bool erase(const K& key) {
+			if (count == 0) {
+				return false;
+			}
+
+			size_t index = probe(key);
+
+			if (!entries[index].used) {
+				return false;
+			}
+
+			// backward shift deletion, move back all the entries that would become unreachable
+			size_t next = (index + 1) & mask();
+
+			while (entries[next].used) {
+				const size_t home = slot(entries[next].key);
+
+				// the entry can fill the hole only if the hole lies on its probe sequence
+				if (((next - home) & mask()) >= ((next - index) & mask())) {
+					entries[index].key = std::move(entries[next].key);
+					entries[index].value = std::move(entries[next].value);
+					index = next;
+				}
+
+				next = (next + 1) & mask();
+			}
+
+			entries[index].used = false;
+			entries[index].key = K {};
+			entries[index].value = V {};
+			count --;
+
+			return true;
+		}
+
+		/// Get the number of elements in this map
+		size_t size() const {
+			return count;
+		}
+
+		/// Check if the map is empty
+		bool empty() const {
+			return count == 0;
+		}
+
+		/// Call the function with every key and value, in unspecified order
+		template <typename F>
+		void forEach(F function) {
+			for (Entry& entry : entries) {
+				if (entry.used) {
+					function(entry.key, entry.value);
+				}
+			}
+		}
+
+		/// Remove all elements
+		void clear() {
+			entries.clear();
+			count = 0;
+		}
+
+};
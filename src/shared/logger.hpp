@@ -61,15 +61,19 @@ class Logger {
 
 			const auto time = std::time(nullptr);
 
-			std::ostringstream s;
-			s << std::put_time(std::localtime(&time), "[%H:%M:%S]");
-			s << " ";
-			s << getLevelName(level);
-			s << ": ";
-			s << format;
-			s << "\n";
-
-			const std::string fmt = s.str();
+			char stamp[16];
+			std::strftime(stamp, sizeof(stamp), "[%H:%M:%S]", std::localtime(&time));
+
+			// the buffer is reused, so once it grows large enough logging doesn't allocate
+			thread_local std::string fmt;
+			fmt.clear();
+			fmt += stamp;
+			fmt += " ";
+			fmt += getLevelName(level);
+			fmt += ": ";
+			fmt += format;
+			fmt += "\n";
+
 			print(fmt.c_str(), args...);
 		}
 
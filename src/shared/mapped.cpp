@@ -0,0 +1,97 @@
+#include "mapped.hpp"
+
+#if __has_include(<sys/mman.h>)
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#	define MAPPED_FILE_MMAP 1
+#endif
+
+/*
+ * MappedFile
+ */
+
+MappedFile::MappedFile()
+: bytes(nullptr), length(0), mapped(false) {}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(const std::string& path) {
+	close();
+
+#if MAPPED_FILE_MMAP
+	const int descriptor = ::open(path.c_str(), O_RDONLY);
+
+	if (descriptor < 0) {
+		return false;
+	}
+
+	struct stat status {};
+
+	if (fstat(descriptor, &status) != 0) {
+		::close(descriptor);
+		return false;
+	}
+
+	length = status.st_size;
+
+	// mmap rejects empty mappings, an empty file is still a valid (empty) view
+	if (length > 0) {
+		void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+		if (address == MAP_FAILED) {
+			::close(descriptor);
+			length = 0;
+			return false;
+		}
+
+		// the whole file is going to be read front to back
+		madvise(address, length, MADV_SEQUENTIAL);
+
+		bytes = static_cast<const uint8_t*>(address);
+		mapped = true;
+	}
+
+	// the mapping keeps its own reference to the file
+	::close(descriptor);
+	return true;
+#else
+	std::ifstream file {path, std::ios::binary | std::ios::ate};
+
+	if (!file) {
+		return false;
+	}
+
+	fallback.resize(file.tellg());
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(fallback.data()), fallback.size());
+
+	bytes = fallback.data();
+	length = fallback.size();
+	return true;
+#endif
+}
+
+void MappedFile::close() {
+#if MAPPED_FILE_MMAP
+	if (mapped) {
+		munmap(const_cast<uint8_t*>(bytes), length);
+	}
+#endif
+
+	fallback.clear();
+	bytes = nullptr;
+	length = 0;
+	mapped = false;
+}
+
+const uint8_t* MappedFile::data() const {
+	return bytes;
+}
+
+size_t MappedFile::size() const {
+	return length;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "external.hpp"
+
+/**
+ * Read-only view of a whole file, on POSIX systems the file is memory mapped so
+ * nothing is copied until the bytes are actually touched, elsewhere the file is read into memory
+ */
+class MappedFile {
+
+	private:
+
+		const uint8_t* bytes;
+		size_t length;
+		bool mapped;
+		std::vector<uint8_t> fallback;
+
+	public:
+
+		MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile();
+
+		/**
+		 * Maps the file at the given path, returns false if it could not be opened
+		 */
+		bool open(const std::string& path);
+
+		/**
+		 * Unmaps the file, all pointers returned by data() are invalidated
+		 */
+		void close();
+
+		/**
+		 * Returns pointer to the first byte of the file
+		 */
+		const uint8_t* data() const;
+
+		/**
+		 * Returns size of the file in bytes
+		 */
+		size_t size() const;
+
+};
@@ -0,0 +1,124 @@
+#include "slab.hpp"
+
+#if __has_include(<cxxabi.h>)
+#	include <cxxabi.h>
+#endif
+
+/*
+ * SlabPool
+ */
+
+static std::string demangle(const char* name) {
+#if __has_include(<cxxabi.h>)
+	int status = 0;
+	char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+
+	if (status == 0 && demangled != nullptr) {
+		std::string result {demangled};
+		std::free(demangled);
+		return result;
+	}
+#endif
+
+	return name;
+}
+
+std::mutex& SlabPool::registryMutex() {
+	static std::mutex mutex;
+	return mutex;
+}
+
+std::vector<SlabPool*>& SlabPool::registry() {
+	static std::vector<SlabPool*> pools;
+	return pools;
+}
+
+void SlabPool::grow() {
+	void* slab = ::operator new(block_size * blocks_per_slab, std::align_val_t {alignment});
+	slabs.push_back(slab);
+
+	char* bytes = static_cast<char*>(slab);
+
+	// link in reverse so that blocks are handed out in address order
+	for (size_t i = blocks_per_slab; i > 0; i --) {
+		Block* block = reinterpret_cast<Block*>(bytes + (i - 1) * block_size);
+		block->next = free_list;
+		free_list = block;
+	}
+
+	capacity += blocks_per_slab;
+}
+
+SlabPool::SlabPool(const std::type_info& type, size_t size, size_t alignment)
+: name(demangle(type.name())), free_list(nullptr), live(0), peak(0), capacity(0) {
+	this->alignment = std::max(alignment, alignof(Block));
+
+	// every block must be able to hold the free list link and keep the next block aligned
+	const size_t bytes = std::max(size, sizeof(Block));
+	this->block_size = (bytes + this->alignment - 1) / this->alignment * this->alignment;
+	this->blocks_per_slab = std::max<size_t>(16, 16384 / block_size);
+
+	std::lock_guard lock {registryMutex()};
+	registry().push_back(this);
+}
+
+SlabPool::~SlabPool() {
+	{
+		std::lock_guard lock {registryMutex()};
+		std::erase(registry(), this);
+	}
+
+	for (void* slab : slabs) {
+		::operator delete(slab, std::align_val_t {alignment});
+	}
+}
+
+void* SlabPool::allocate() {
+	std::lock_guard lock {mutex};
+
+	if (free_list == nullptr) {
+		grow();
+	}
+
+	Block* block = free_list;
+	free_list = block->next;
+
+	live ++;
+	peak = std::max(peak, live);
+
+	return block;
+}
+
+void SlabPool::deallocate(void* pointer) {
+	std::lock_guard lock {mutex};
+
+	Block* block = static_cast<Block*>(pointer);
+	block->next = free_list;
+	free_list = block;
+
+	live --;
+}
+
+void SlabPool::reserve(size_t count) {
+	std::lock_guard lock {mutex};
+
+	while (capacity - live < count) {
+		grow();
+	}
+}
+
+SlabStatistics SlabPool::getStatistics() {
+	std::lock_guard lock {mutex};
+	return {name, block_size, live, peak, capacity};
+}
+
+std::vector<SlabStatistics> SlabPool::getAllStatistics() {
+	std::lock_guard lock {registryMutex()};
+	std::vector<SlabStatistics> statistics;
+
+	for (SlabPool* pool : registry()) {
+		statistics.push_back(pool->getStatistics());
+	}
+
+	return statistics;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "external.hpp"
+
+/**
+ * Snapshot of the state of a single SlabPool
+ */
+struct SlabStatistics {
+	std::string name;
+	size_t block_size;
+	size_t live;
+	size_t peak;
+	size_t capacity;
+};
+
+/**
+ * Thread-safe free-list allocator of fixed size blocks, memory is
+ * requested from the system in slabs of many blocks and freed blocks are recycled,
+ * so after the pool warms up allocation and deallocation cost a mutex and a pointer swap
+ */
+class SlabPool {
+
+	private:
+
+		struct Block {
+			Block* next;
+		};
+
+		std::mutex mutex;
+		std::string name;
+		size_t block_size;
+		size_t alignment;
+		size_t blocks_per_slab;
+
+		std::vector<void*> slabs;
+		Block* free_list;
+
+		size_t live;
+		size_t peak;
+		size_t capacity;
+
+		static std::mutex& registryMutex();
+		static std::vector<SlabPool*>& registry();
+
+		/// Allocate new slab and link all its blocks into the free list
+		void grow();
+
+	public:
+
+		SlabPool(const std::type_info& type, size_t size, size_t alignment);
+		~SlabPool();
+
+		/**
+		 * Returns a free block, the pool grows if there is none
+		 */
+		void* allocate();
+
+		/**
+		 * Returns the block to the pool, the memory is kept for reuse
+		 */
+		void deallocate(void* pointer);
+
+		/**
+		 * Grows the pool so that the given number of blocks can be allocated without growing it again
+		 */
+		void reserve(size_t count);
+
+		/**
+		 * Returns the live and peak block count of this pool
+		 */
+		SlabStatistics getStatistics();
+
+		/**
+		 * Returns statistics of all pools that exist in the program
+		 */
+		static std::vector<SlabStatistics> getAllStatistics();
+
+};
+
+/**
+ * The pool used by SlabAllocators with the given tag, shared_ptrs allocate their control
+ * block through a rebound allocator, so it's only known after the first allocation
+ */
+template <typename Tag>
+struct SlabTag {
+	inline static std::atomic<SlabPool*> pool = nullptr;
+};
+
+/**
+ * Standard allocator backed by a SlabPool, one pool exists for each allocated type,
+ * use with std::allocate_shared, the pool of the (rebound) control block type is reported under the name of Tag
+ */
+template <typename T, typename Tag = T>
+class SlabAllocator {
+
+	public:
+
+		using value_type = T;
+
+		template <typename U>
+		struct rebind {
+			using other = SlabAllocator<U, Tag>;
+		};
+
+		SlabAllocator() = default;
+
+		template <typename U>
+		SlabAllocator(const SlabAllocator<U, Tag>&) {}
+
+		/// Get the pool used for all single element allocations of this type
+		static SlabPool& pool() {
+
+			// never destroyed, objects can still be released during static destruction
+			static SlabPool* pool = SlabTag<Tag>::pool = new SlabPool(typeid(Tag), sizeof(T), alignof(T));
+			return *pool;
+		}
+
+		/// Reserve blocks for the given number of objects tagged with Tag, does nothing before the first such object is allocated
+		static void reserve(size_t count) {
+			if (SlabPool* pool = SlabTag<Tag>::pool.load()) {
+				pool->reserve(count);
+			}
+		}
+
+		T* allocate(size_t count) {
+			if (count != 1) {
+				return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t {alignof(T)}));
+			}
+
+			return static_cast<T*>(pool().allocate());
+		}
+
+		void deallocate(T* pointer, size_t count) {
+			if (count != 1) {
+				::operator delete(pointer, std::align_val_t {alignof(T)});
+				return;
+			}
+
+			pool().deallocate(pointer);
+		}
+
+		template <typename U>
+		bool operator==(const SlabAllocator<U, Tag>&) const {
+			return true;
+		}
+
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "external.hpp"
+
+/**
+ * Stable reference to an element of a SlotMap, stays valid after other elements are
+ * added or removed and reliably expires after its own element is removed (even if the slot gets reused)
+ */
+template <typename T>
+struct Handle {
+
+	static constexpr uint32_t INVALID = UINT32_MAX;
+
+	uint32_t index = INVALID;
+	uint32_t generation = 0;
+
+	/// Check if the handle was ever assigned, doesn't check if the element still exists
+	explicit operator bool() const {
+		return index != INVALID;
+	}
+
+	bool operator==(const Handle& other) const = default;
+
+};
+
+template <typename T>
+class SlotMap {
+
+	private:
+
+		struct Slot {
+			T value;
+			uint32_t generation;
+			uint32_t next;
+		};
+
+		// marks occupied slots, free slots link to the next free slot instead
+		static constexpr uint32_t LIVE = Handle<T>::INVALID - 1;
+
+		std::vector<Slot> slots;
+		uint32_t free_head = Handle<T>::INVALID;
+		size_t count = 0;
+
+	public:
+
+		/// Insert new element, reusing a free slot if there is one
+		Handle<T> insert(const T& value) {
+			count ++;
+
+			if (free_head != Handle<T>::INVALID) {
+				const uint32_t index = free_head;
+				Slot& slot = slots[index];
+
+				free_head = slot.next;
+				slot.value = value;
+				slot.next = LIVE;
+
+				return {index, slot.generation};
+			}
+
+			const uint32_t index = slots.size();
+			slots.emplace_back(value, 0, LIVE);
+
+			return {index, 0};
+		}
+
+		/// Preallocate space for the given number of elements
+		void reserve(size_t capacity) {
+			slots.reserve(capacity);
+		}
+
+		/// Remove element by handle, returns false if it was already removed
+		bool remove(Handle<T> handle) {
+			if (!contains(handle)) {
+				return false;
+			}
+
+			Slot& slot = slots[handle.index];
+
+			// invalidates all the handles to the removed element
+			slot.generation ++;
+			slot.value = T {};
+			slot.next = free_head;
+
+			free_head = handle.index;
+			count --;
+
+			return true;
+		}
+
+		/// Check if the element referenced by the handle still exists
+		bool contains(Handle<T> handle) const {
+			return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+		}
+
+		/// Get pointer to the element referenced by the handle, or nullptr if it no longer exists
+		T* get(Handle<T> handle) {
+			return contains(handle) ? &slots[handle.index].value : nullptr;
+		}
+
+		/// Call the function with every element of this map, in slot order
+		template <typename F>
+		void forEach(F func) {
+			for (Slot& slot : slots) {
+				if (slot.next == LIVE) {
+					func(slot.value);
+				}
+			}
+		}
+
+		/// Get the number of elements in this map
+		size_t size() const {
+			return count;
+		}
+
+		/// Check if the map is empty
+		bool empty() const {
+			return count == 0;
+		}
+
+		/// Remove all elements, invalidating all the handles
+		void clear() {
+			free_head = Handle<T>::INVALID;
+			count = 0;
+
+			for (uint32_t i = slots.size(); i > 0; i --) {
+				Slot& slot = slots[i - 1];
+
+				slot.generation ++;
+				slot.value = T {};
+				slot.next = free_head;
+
+				free_head = i - 1;
+			}
+		}
+
+};
@@ -0,0 +1,215 @@
+#include "bus.hpp"
+#include "shared/logger.hpp"
+
+/*
+ * Message
+ */
+
+void Message::destroy() {
+	if (heap) {
+		type->release(heap);
+		return;
+	}
+
+	type->destroy(storage);
+}
+
+/*
+ * MessageBus::Lane
+ */
+
+MessageBus::Lane::Lane() {
+	tail = head = new Block;
+}
+
+MessageBus::Lane::~Lane() {
+
+	// destroy the messages that were never delivered
+	for (Block* block = head; block != nullptr; ) {
+		const uint32_t count = block->count.load(std::memory_order_acquire);
+
+		for (uint32_t i = (block == head ? read : 0); i < count; i ++) {
+			block->slots[i].destroy();
+		}
+
+		Block* next = block->next.load(std::memory_order_acquire);
+		delete block;
+		block = next;
+	}
+
+	for (Block* block = free.load(); block != nullptr; ) {
+		Block* next = block->free_next;
+		delete block;
+		block = next;
+	}
+}
+
+Message& MessageBus::Lane::acquire() {
+	const uint32_t count = tail->count.load(std::memory_order_relaxed);
+
+	if (count < Block::CAPACITY) {
+		return tail->slots[count];
+	}
+
+	Block* block = free.load(std::memory_order_acquire);
+
+	while (block != nullptr && !free.compare_exchange_weak(block, block->free_next, std::memory_order_acquire)) {
+		// retry with the new top
+	}
+
+	if (block == nullptr) {
+		block = new Block;
+	} else {
+		block->count.store(0, std::memory_order_relaxed);
+		block->next.store(nullptr, std::memory_order_relaxed);
+	}
+
+	// the consumer only moves to the next block after it was linked, so the reset above is visible to it
+	tail->next.store(block, std::memory_order_release);
+	tail = block;
+
+	return block->slots[0];
+}
+
+void MessageBus::Lane::commit() {
+	tail->count.store(tail->count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/*
+ * MessageBus
+ */
+
+MessageBus::~MessageBus() {
+	for (std::atomic<Lane*>& lane : lanes) {
+		delete lane.load();
+	}
+}
+
+size_t MessageBus::threadIndex() {
+
+	struct ThreadSlot {
+		static std::mutex& mutex() {
+			static std::mutex mutex;
+			return mutex;
+		}
+
+		static std::vector<size_t>& released() {
+			static std::vector<size_t> released;
+			return released;
+		}
+
+		size_t index;
+
+		ThreadSlot() {
+			static size_t next = 0;
+			std::lock_guard lock {mutex()};
+
+			if (released().empty()) {
+				index = next ++;
+				return;
+			}
+
+			// prefer the lowest index so that threads keep using the lock-free lanes
+			auto lowest = std::ranges::min_element(released());
+			index = *lowest;
+			released().erase(lowest);
+		}
+
+		~ThreadSlot() {
+			std::lock_guard lock {mutex()};
+			released().push_back(index);
+		}
+	};
+
+	thread_local ThreadSlot slot;
+	return slot.index;
+}
+
+MessageBus::Lane* MessageBus::laneOf(size_t index) {
+	Lane* lane = lanes[index].load(std::memory_order_acquire);
+
+	// only the thread with this index creates its lane, so no compare-exchange is needed
+	if (lane == nullptr) {
+		lane = new Lane;
+		lanes[index].store(lane, std::memory_order_release);
+	}
+
+	return lane;
+}
+
+void MessageBus::collect(Lane& lane) {
+	while (true) {
+		Block* block = lane.head;
+		const uint32_t count = block->count.load(std::memory_order_acquire);
+
+		for (uint32_t i = lane.read; i < count; i ++) {
+			batch.push_back(&block->slots[i]);
+		}
+
+		lane.read = count;
+
+		if (count < Block::CAPACITY) {
+			return;
+		}
+
+		Block* next = block->next.load(std::memory_order_acquire);
+
+		if (next == nullptr) {
+			return;
+		}
+
+		// the producer already moved on, the block is recycled after the delivery
+		retired.emplace_back(&lane, block);
+		lane.head = next;
+		lane.read = 0;
+	}
+}
+
+size_t MessageBus::deliver(const std::function<void(uint64_t, std::span<Message* const>)>& handler) {
+	batch.clear();
+	retired.clear();
+
+	for (std::atomic<Lane*>& lane : lanes) {
+		if (Lane* pointer = lane.load(std::memory_order_acquire)) {
+			collect(*pointer);
+		}
+	}
+
+	collect(overflow);
+
+	// stable, so that the messages from one thread stay in the posting order
+	std::ranges::stable_sort(batch, {}, [] (const Message* message) {
+		return message->receiver;
+	});
+
+	for (size_t begin = 0; begin < batch.size(); ) {
+		const uint64_t receiver = batch[begin]->receiver;
+		size_t end = begin + 1;
+
+		while (end < batch.size() && batch[end]->receiver == receiver) {
+			end ++;
+		}
+
+		try {
+			handler(receiver, std::span {batch.data() + begin, end - begin});
+		} catch (std::exception& exception) {
+			out::warn("Exception while delivering messages: %s", exception.what());
+		}
+
+		begin = end;
+	}
+
+	for (Message* message : batch) {
+		message->destroy();
+	}
+
+	for (auto [lane, block] : retired) {
+		Block* top = lane->free.load(std::memory_order_relaxed);
+
+		do {
+			block->free_next = top;
+		} while (!lane->free.compare_exchange_weak(top, block, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	return batch.size();
+}
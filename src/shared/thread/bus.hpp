@@ -0,0 +1,190 @@
+#pragma once
+
+#include "external.hpp"
+#include <span>
+
+/**
+ * Type information of a message payload, one instance exists for each
+ * payload type, so its address can be used to identify the type
+ */
+struct MessageType {
+
+	const char* name;
+	void (*destroy) (void* payload);
+	void (*release) (void* payload);
+
+	template <typename T>
+	static const MessageType* of() {
+		static const MessageType type {
+			typeid(T).name(),
+			[] (void* payload) { static_cast<T*>(payload)->~T(); },
+			[] (void* payload) { delete static_cast<T*>(payload); }
+		};
+
+		return &type;
+	}
+
+};
+
+/**
+ * Envelope of a single posted message, payloads that fit in the
+ * envelope are stored inline, so posting them doesn't allocate
+ */
+class Message {
+
+	public:
+
+		static constexpr size_t INLINE_SIZE = 48;
+
+	private:
+
+		friend class MessageBus;
+
+		const MessageType* type;
+		uint64_t receiver;
+		void* heap;
+		alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+
+		template <typename T>
+		static constexpr bool fitsInline() {
+			return sizeof(T) <= INLINE_SIZE && alignof(T) <= alignof(std::max_align_t);
+		}
+
+		/// Destroy the payload, the envelope can be reused afterwards
+		void destroy();
+
+	public:
+
+		/// Get the receiver this message was posted to
+		uint64_t getReceiver() const {
+			return receiver;
+		}
+
+		/// Check if the payload is of the given type
+		template <typename T>
+		bool is() const {
+			return type == MessageType::of<T>();
+		}
+
+		/// Get the payload, the type needs to match, see is()
+		template <typename T>
+		const T& as() const {
+			return *static_cast<const T*>(heap ? heap : storage);
+		}
+
+		/// Get the type information of the payload
+		const MessageType* getType() const {
+			return type;
+		}
+
+};
+
+/**
+ * Lock-free multi-producer single-consumer message queue, every posting thread
+ * appends to its own lane of reusable blocks (so producers never contend), and the consumer
+ * drains all lanes at once and delivers the messages grouped by their receivers
+ */
+class MessageBus {
+
+	public:
+
+		/// Threads with a higher index share a single locked lane
+		static constexpr size_t MAX_LANES = 64;
+
+	private:
+
+		struct Block {
+			static constexpr uint32_t CAPACITY = 64;
+
+			// number of published slots, written by the producer only
+			std::atomic<uint32_t> count {0};
+			std::atomic<Block*> next {nullptr};
+			Block* free_next = nullptr;
+			Message slots[CAPACITY];
+		};
+
+		struct Lane {
+			// producer side
+			Block* tail;
+
+			// consumer side
+			Block* head;
+			uint32_t read = 0;
+
+			// blocks returned by the consumer, only the owning producer pops them, so there is no ABA problem
+			std::atomic<Block*> free {nullptr};
+
+			Lane();
+			~Lane();
+
+			/// Get an empty envelope at the end of the lane, publish it with commit()
+			Message& acquire();
+			void commit();
+		};
+
+		std::array<std::atomic<Lane*>, MAX_LANES> lanes {};
+		std::mutex overflow_mutex;
+		Lane overflow;
+
+		// consumer scratch, reused between deliveries
+		std::vector<Message*> batch;
+		std::vector<std::pair<Lane*, Block*>> retired;
+
+		/// Get the lane of the calling thread, creates it on the first call
+		Lane* laneOf(size_t index);
+
+		/// Collect all the published messages of the lane into the batch
+		void collect(Lane& lane);
+
+		template <typename T>
+		void emplace(Message& message, uint64_t receiver, T&& value) {
+			using V = std::decay_t<T>;
+
+			message.type = MessageType::of<V>();
+			message.receiver = receiver;
+
+			if constexpr (Message::fitsInline<V>()) {
+				new (message.storage) V {std::forward<T>(value)};
+				message.heap = nullptr;
+			} else {
+				message.heap = new V {std::forward<T>(value)};
+			}
+		}
+
+	public:
+
+		MessageBus() = default;
+		MessageBus(const MessageBus&) = delete;
+		~MessageBus();
+
+		/// Get the index of the calling thread, indices of exited threads are reused
+		static size_t threadIndex();
+
+		/**
+		 * Post a message to the receiver, can be called from any thread,
+		 * the message will be delivered by the next call to deliver()
+		 */
+		template <typename T>
+		void post(uint64_t receiver, T&& value) {
+			const size_t index = threadIndex();
+
+			if (index >= MAX_LANES) {
+				std::lock_guard lock {overflow_mutex};
+				emplace(overflow.acquire(), receiver, std::forward<T>(value));
+				overflow.commit();
+				return;
+			}
+
+			Lane* lane = laneOf(index);
+			emplace(lane->acquire(), receiver, std::forward<T>(value));
+			lane->commit();
+		}
+
+		/**
+		 * Deliver all the messages posted so far, the handler is called once for each receiver with all its messages,
+		 * messages from a single thread stay in the posting order, can only be called from one thread at a time,
+		 * messages posted by the handler are delivered by the next call, returns the number of delivered messages
+		 */
+		size_t deliver(const std::function<void(uint64_t, std::span<Message* const>)>& handler);
+
+};
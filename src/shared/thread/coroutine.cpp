@@ -0,0 +1,45 @@
+#include "coroutine.hpp"
+
+/*
+ * AsyncEvent
+ */
+
+bool AsyncEvent::Awaiter::await_ready() const {
+	return event.isSet();
+}
+
+bool AsyncEvent::Awaiter::await_suspend(std::coroutine_handle<> handle) const {
+	std::lock_guard lock {event.mutex};
+
+	// the event could have been set in the meantime, then just continue
+	if (event.ready) {
+		return false;
+	}
+
+	event.waiting.push_back(handle);
+	return true;
+}
+
+void AsyncEvent::set() {
+	std::vector<std::coroutine_handle<>> resumed;
+
+	{
+		std::lock_guard lock {mutex};
+		ready = true;
+		resumed.swap(waiting);
+	}
+
+	for (std::coroutine_handle<> handle : resumed) {
+		handle.resume();
+	}
+}
+
+void AsyncEvent::reset() {
+	std::lock_guard lock {mutex};
+	ready = false;
+}
+
+bool AsyncEvent::isSet() {
+	std::lock_guard lock {mutex};
+	return ready;
+}
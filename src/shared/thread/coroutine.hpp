@@ -0,0 +1,287 @@
+#pragma once
+
+#include <coroutine>
+#include "handle.hpp"
+#include "shared/queue.hpp"
+
+template <typename T>
+class Async;
+
+/**
+ * Suspends the coroutine until the task state completes, the coroutine
+ * is resumed on the thread that completes it, or continues right away if it already did
+ */
+struct StateAwaiter {
+
+	std::shared_ptr<TaskState> state;
+
+	bool await_ready() const {
+		return state->isDone();
+	}
+
+	bool await_suspend(std::coroutine_handle<> handle) const {
+		Task resume = [handle] () {
+			handle.resume();
+		};
+
+		// the state could have completed in the meantime, then just continue
+		return state->addContinuation(resume);
+	}
+
+	void await_resume() const {}
+
+};
+
+/**
+ * Completion of Async coroutines, separate from the promise as a promise can't have both return_value() and return_void()
+ */
+template <typename T>
+struct AsyncPromiseBase {
+
+	std::shared_ptr<ValueState<T>> state = std::make_shared<ValueState<T>>();
+
+	template <typename V>
+	void return_value(V&& value) {
+		state->complete(T(std::forward<V>(value)));
+	}
+
+};
+
+template <>
+struct AsyncPromiseBase<void> {
+
+	std::shared_ptr<ValueState<void>> state = std::make_shared<ValueState<void>>();
+
+	void return_void() {
+		state->complete();
+	}
+
+};
+
+/**
+ * Coroutine that runs asynchronously to its caller, it starts on the calling thread and runs until its first suspension,
+ * after that it continues on whatever thread resumes it, see tasks::resumeOn(), it's fine to drop the Async
+ * object, the coroutine will still run to completion, awaiting an Async suspends the awaiting coroutine until it completes
+ */
+template <typename T = void>
+class Async {
+
+	public:
+
+		struct promise_type : AsyncPromiseBase<T> {
+
+			Async get_return_object() {
+				return Async {this->state};
+			}
+
+			std::suspend_never initial_suspend() noexcept {
+				return {};
+			}
+
+			// the frame is destroyed right after the coroutine completes, the result lives in the shared state
+			std::suspend_never final_suspend() noexcept {
+				return {};
+			}
+
+			void unhandled_exception() {
+				this->state->fail(std::current_exception());
+			}
+
+		};
+
+	private:
+
+		std::shared_ptr<ValueState<T>> state;
+
+		explicit Async(std::shared_ptr<ValueState<T>> state)
+		: state(std::move(state)) {}
+
+		// the result is copied, a reference could outlive the awaited state
+		struct Awaiter : StateAwaiter {
+			auto await_resume() const {
+				return Async::result(*static_cast<ValueState<T>*>(this->state.get()));
+			}
+		};
+
+		static decltype(auto) result(ValueState<T>& state) {
+			if (std::exception_ptr exception = state.getException()) {
+				std::rethrow_exception(exception);
+			}
+
+			if constexpr (!std::is_void_v<T>) {
+				return static_cast<const T&>(*state.value);
+			}
+		}
+
+	public:
+
+		/// Check if the coroutine has already completed
+		bool isDone() const {
+			return state->isDone();
+		}
+
+		/// Block until the coroutine completes, avoid calling this from within the pool's tasks
+		void wait() const {
+			state->wait();
+		}
+
+		/// Block until the coroutine completes and return its result, rethrows the exception it failed with
+		decltype(auto) get() const {
+			state->wait();
+			return result(*state);
+		}
+
+		/// Get the completion state of this coroutine, see tasks::whenAll()
+		std::shared_ptr<TaskState> getState() const {
+			return state;
+		}
+
+		Awaiter operator co_await() const {
+			return Awaiter {state};
+		}
+
+};
+
+/**
+ * Awaiting a task handle suspends the coroutine until the task completes, and returns its result
+ */
+template <typename T>
+auto operator co_await(const TaskHandle<T>& handle) {
+	struct Awaiter : StateAwaiter {
+		TaskHandle<T> handle;
+
+		auto await_resume() const {
+			return handle.get();
+		}
+	};
+
+	return Awaiter {{handle.getState()}, handle};
+}
+
+/**
+ * Manual reset event that coroutines can await, the waiting coroutines
+ * are resumed on the thread that calls set(), awaiting an event that is already set doesn't suspend
+ */
+class AsyncEvent {
+
+	private:
+
+		std::mutex mutex;
+		std::vector<std::coroutine_handle<>> waiting;
+		bool ready = false;
+
+		struct Awaiter {
+			AsyncEvent& event;
+
+			bool await_ready() const;
+			bool await_suspend(std::coroutine_handle<> handle) const;
+			void await_resume() const {}
+		};
+
+	public:
+
+		/// Set the event and resume all the coroutines waiting for it
+		void set();
+
+		/// Reset the event, so that the next await suspends again
+		void reset();
+
+		/// Check if the event is set
+		bool isSet();
+
+		Awaiter operator co_await() {
+			return Awaiter {*this};
+		}
+
+};
+
+namespace tasks {
+
+	/**
+	 * Suspends the coroutine and resumes it on one of the pool's workers
+	 */
+	struct PoolAwaiter {
+		TaskPool& pool;
+
+		bool await_ready() const {
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> handle) const {
+			pool.enqueue([handle] () {
+				handle.resume();
+			});
+		}
+
+		void await_resume() const {}
+	};
+
+	/**
+	 * Suspends the coroutine and resumes it during the next execute() of the queue, await
+	 * BoardManager::getFrameQueue() to continue on the main thread at the start of the next frame
+	 */
+	struct QueueAwaiter {
+		TaskQueue& queue;
+
+		bool await_ready() const {
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> handle) const {
+			queue.enqueue([handle] () {
+				handle.resume();
+			});
+		}
+
+		void await_resume() const {}
+	};
+
+	/**
+	 * Suspends the coroutine until the future is ready, the future is checked during every execute()
+	 * of the queue, so no thread is held waiting for it, returns the value of the future
+	 */
+	template <typename T>
+	struct FutureAwaiter {
+		std::shared_future<T> future;
+		TaskQueue& queue;
+
+		bool await_ready() const {
+			return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}
+
+		void await_suspend(std::coroutine_handle<> handle) const {
+			queue.enqueue([future = future, &queue = queue, handle] () {
+				poll(future, queue, handle);
+			});
+		}
+
+		auto await_resume() const {
+			return future.get();
+		}
+
+		static void poll(const std::shared_future<T>& future, TaskQueue& queue, std::coroutine_handle<> handle) {
+			if (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+				handle.resume();
+				return;
+			}
+
+			queue.enqueue([future, &queue, handle] () {
+				poll(future, queue, handle);
+			});
+		}
+	};
+
+	inline PoolAwaiter resumeOn(TaskPool& pool) {
+		return {pool};
+	}
+
+	inline QueueAwaiter resumeOn(TaskQueue& queue) {
+		return {queue};
+	}
+
+	template <typename T>
+	FutureAwaiter<T> awaitFuture(std::shared_future<T> future, TaskQueue& queue) {
+		return {std::move(future), queue};
+	}
+
+}
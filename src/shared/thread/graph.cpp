@@ -0,0 +1,195 @@
+#include "graph.hpp"
+
+/*
+ * JobGraph
+ */
+
+uint32_t JobGraph::resourceOf(std::string_view name) {
+	const auto [it, inserted] = resources.try_emplace(std::string {name}, resources.size());
+	return it->second;
+}
+
+bool JobGraph::conflicts(const Job& first, const Job& second) {
+	auto intersects = [] (const std::vector<uint32_t>& left, const std::vector<uint32_t>& right) {
+		return std::ranges::any_of(left, [&] (uint32_t resource) {
+			return std::ranges::find(right, resource) != right.end();
+		});
+	};
+
+	return intersects(first.writes, second.writes) || intersects(first.writes, second.reads) || intersects(first.reads, second.writes);
+}
+
+void JobGraph::execute(TaskPool& pool, size_t index, const Timer& timer) {
+	Job& job = jobs[index];
+	job.start = timer.milliseconds();
+
+	try {
+		job.task();
+	} catch (std::exception& exception) {
+		printf("WARN: Exception in job '%s': %s\n", job.name.c_str(), exception.what());
+	} catch (...) {
+		printf("WARN: Unknown error in job '%s'!\n", job.name.c_str());
+	}
+
+	job.end = timer.milliseconds();
+
+	std::unique_lock lock {mutex};
+
+	for (size_t successor : job.successors) {
+		if (-- pending[successor] == 0) {
+			schedule(pool, successor, timer);
+		}
+	}
+
+	// notify under the lock, run() may return and the graph be destroyed as soon as the lock is released
+	remaining --;
+	condition.notify_all();
+}
+
+void JobGraph::schedule(TaskPool& pool, size_t index, const Timer& timer) {
+	if (jobs[index].main_thread) {
+		main_ready.push_back(index);
+		return;
+	}
+
+	// the main thread waits for the whole graph, so its jobs go before everything else
+	pool.enqueue([this, &pool, index, &timer] () {
+		execute(pool, index, timer);
+	}, TaskPriority::CRITICAL);
+}
+
+void JobGraph::computeCriticalPath() {
+	std::vector<double> longest(jobs.size());
+	std::vector<size_t> previous(jobs.size(), SIZE_MAX);
+	size_t last = SIZE_MAX;
+
+	// predecessors always have lower indices, so the jobs are already in a topological order
+	for (size_t i = 0; i < jobs.size(); i ++) {
+		double before = 0;
+
+		for (size_t predecessor : jobs[i].predecessors) {
+			if (longest[predecessor] > before) {
+				before = longest[predecessor];
+				previous[i] = predecessor;
+			}
+		}
+
+		longest[i] = before + (jobs[i].end - jobs[i].start);
+
+		if (last == SIZE_MAX || longest[i] > longest[last]) {
+			last = i;
+		}
+	}
+
+	critical_path.clear();
+	critical_time = last == SIZE_MAX ? 0 : longest[last];
+
+	for (size_t i = last; i != SIZE_MAX; i = previous[i]) {
+		critical_path.push_back(i);
+	}
+
+	std::ranges::reverse(critical_path);
+}
+
+size_t JobGraph::add(const std::string& name, std::initializer_list<std::string_view> reads, std::initializer_list<std::string_view> writes, Task task, bool main_thread) {
+	const size_t index = jobs.size();
+	Job& job = jobs.emplace_back();
+
+	job.name = name;
+	job.task = std::move(task);
+	job.main_thread = main_thread;
+
+	for (std::string_view resource : reads) {
+		job.reads.push_back(resourceOf(resource));
+	}
+
+	for (std::string_view resource : writes) {
+		job.writes.push_back(resourceOf(resource));
+	}
+
+	for (size_t i = 0; i < index; i ++) {
+		if (conflicts(jobs[i], job)) {
+			depend(index, i);
+		}
+	}
+
+	return index;
+}
+
+void JobGraph::depend(size_t job, size_t on) {
+	if (on >= job) {
+		throw std::invalid_argument {"Jobs can only depend on the jobs added before them!"};
+	}
+
+	if (std::ranges::find(jobs[job].predecessors, on) == jobs[job].predecessors.end()) {
+		jobs[job].predecessors.push_back(on);
+		jobs[on].successors.push_back(job);
+	}
+}
+
+void JobGraph::run(TaskPool& pool) {
+	Timer timer;
+	std::unique_lock lock {mutex};
+
+	pending.resize(jobs.size());
+	remaining = jobs.size();
+
+	for (size_t i = 0; i < jobs.size(); i ++) {
+		pending[i] = jobs[i].predecessors.size();
+
+		if (pending[i] == 0) {
+			schedule(pool, i, timer);
+		}
+	}
+
+	// the calling thread takes part by executing the main thread jobs
+	while (remaining > 0) {
+		condition.wait(lock, [this] { return !main_ready.empty() || remaining == 0; });
+
+		if (!main_ready.empty()) {
+			const size_t index = main_ready.back();
+			main_ready.pop_back();
+
+			lock.unlock();
+			execute(pool, index, timer);
+			lock.lock();
+		}
+	}
+
+	frame_time = timer.milliseconds();
+	computeCriticalPath();
+}
+
+std::vector<std::string> JobGraph::getCriticalPath() const {
+	std::vector<std::string> names;
+
+	for (size_t index : critical_path) {
+		names.push_back(jobs[index].name);
+	}
+
+	return names;
+}
+
+double JobGraph::getCriticalPathTime() const {
+	return critical_time;
+}
+
+double JobGraph::getRunTime() const {
+	return frame_time;
+}
+
+std::string JobGraph::getReport() const {
+	std::ostringstream report;
+	report << "Critical path " << critical_time << "ms of " << frame_time << "ms:";
+
+	for (size_t index : critical_path) {
+		const Job& job = jobs[index];
+		report << " " << job.name << " (" << (job.end - job.start) << "ms)";
+	}
+
+	return report.str();
+}
+
+size_t JobGraph::size() const {
+	return jobs.size();
+}
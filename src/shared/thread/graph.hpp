@@ -0,0 +1,99 @@
+#pragma once
+
+#include "pool.hpp"
+
+/**
+ * A set of jobs with dependencies derived from the resources they access, a job runs after
+ * all the previously added jobs it conflicts with (one of them writes a resource the other one reads or writes),
+ * so jobs that don't conflict run concurrently on the task pool, the graph can be run any number of times
+ */
+class JobGraph {
+
+	private:
+
+		struct Job {
+			std::string name;
+			Task task;
+			bool main_thread;
+
+			std::vector<uint32_t> reads;
+			std::vector<uint32_t> writes;
+			std::vector<size_t> predecessors;
+			std::vector<size_t> successors;
+
+			// timings of the last run, in milliseconds since its start
+			double start = 0;
+			double end = 0;
+		};
+
+		std::vector<Job> jobs;
+		std::unordered_map<std::string, uint32_t> resources;
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::vector<size_t> pending;
+		std::vector<size_t> main_ready;
+		size_t remaining = 0;
+
+		std::vector<size_t> critical_path;
+		double critical_time = 0;
+		double frame_time = 0;
+
+		uint32_t resourceOf(std::string_view name);
+
+		/// Returns true if the two jobs can't run at the same time
+		static bool conflicts(const Job& first, const Job& second);
+
+		/// Run the job on the calling thread and release its successors
+		void execute(TaskPool& pool, size_t index, const Timer& timer);
+
+		/// Hand the job over to the main thread or to the pool, expects the mutex to be locked
+		void schedule(TaskPool& pool, size_t index, const Timer& timer);
+
+		/// Compute the longest chain of dependent jobs of the last run
+		void computeCriticalPath();
+
+	public:
+
+		/**
+		 * Adds a job that reads and writes the given named resources, jobs marked as main thread
+		 * jobs are executed by the thread that calls run(), returns the index of the job
+		 */
+		size_t add(const std::string& name, std::initializer_list<std::string_view> reads, std::initializer_list<std::string_view> writes, Task task, bool main_thread = false);
+
+		/**
+		 * Makes the job wait for an earlier job even if they access no common resources
+		 */
+		void depend(size_t job, size_t on);
+
+		/**
+		 * Runs all the jobs and returns after they all complete, the calling thread executes the main thread jobs
+		 */
+		void run(TaskPool& pool);
+
+		/**
+		 * Returns names of the jobs on the longest chain of dependent jobs of the last run
+		 */
+		std::vector<std::string> getCriticalPath() const;
+
+		/**
+		 * Returns the summed execution time of the jobs on the critical path of the last run, in milliseconds
+		 */
+		double getCriticalPathTime() const;
+
+		/**
+		 * Returns the wall time of the last run, in milliseconds
+		 */
+		double getRunTime() const;
+
+		/**
+		 * Returns a single line description of the critical path of the last run
+		 */
+		std::string getReport() const;
+
+		/**
+		 * Returns the number of jobs in this graph
+		 */
+		size_t size() const;
+
+};
@@ -0,0 +1,130 @@
+#include "handle.hpp"
+#include "shared/logger.hpp"
+
+/*
+ * TaskState
+ */
+
+void TaskState::finish(std::exception_ptr exception) {
+	std::vector<Task> ready;
+
+	{
+		std::lock_guard lock {mutex};
+		this->exception = exception;
+		this->done = true;
+
+		ready = std::move(continuations);
+		condition.notify_all();
+	}
+
+	for (Task& continuation : ready) {
+		try {
+			continuation();
+		} catch (std::exception& error) {
+			out::warn("Exception in task continuation: %s", error.what());
+		}
+	}
+}
+
+void TaskState::onComplete(Task continuation) {
+	if (!addContinuation(continuation)) {
+		continuation();
+	}
+}
+
+bool TaskState::addContinuation(Task& continuation) {
+	std::lock_guard lock {mutex};
+
+	if (done) {
+		return false;
+	}
+
+	continuations.emplace_back(std::move(continuation));
+	return true;
+}
+
+bool TaskState::isDone() {
+	std::lock_guard lock {mutex};
+	return done;
+}
+
+void TaskState::wait() {
+	std::unique_lock lock {mutex};
+	condition.wait(lock, [this] { return done; });
+}
+
+std::exception_ptr TaskState::getException() {
+	std::lock_guard lock {mutex};
+	return exception;
+}
+
+/*
+ * tasks
+ */
+
+TaskHandle<> tasks::whenAll(TaskPool& pool, const std::vector<std::shared_ptr<TaskState>>& states) {
+	auto result = std::make_shared<ValueState<void>>();
+
+	if (states.empty()) {
+		result->complete();
+		return {pool, result};
+	}
+
+	struct Counter {
+		std::atomic<size_t> remaining;
+		std::mutex mutex;
+		std::exception_ptr exception;
+	};
+
+	auto counter = std::make_shared<Counter>();
+	counter->remaining = states.size();
+
+	for (const std::shared_ptr<TaskState>& state : states) {
+
+		// the state is alive while it runs its continuations, a shared pointer would only create a cycle
+		state->onComplete([counter, result, source = state.get()] () {
+			if (std::exception_ptr exception = source->getException()) {
+				std::lock_guard lock {counter->mutex};
+
+				if (!counter->exception) {
+					counter->exception = exception;
+				}
+			}
+
+			if (-- counter->remaining == 0) {
+				counter->exception ? result->fail(counter->exception) : result->complete();
+			}
+		});
+	}
+
+	return {pool, result};
+}
+
+TaskHandle<size_t> tasks::whenAny(TaskPool& pool, const std::vector<std::shared_ptr<TaskState>>& states) {
+	auto result = std::make_shared<ValueState<size_t>>();
+
+	if (states.empty()) {
+		result->fail(std::make_exception_ptr(std::invalid_argument {"Can't wait for any of no tasks!"}));
+		return {pool, result};
+	}
+
+	auto completed = std::make_shared<std::atomic<bool>>(false);
+
+	for (size_t i = 0; i < states.size(); i ++) {
+		states[i]->onComplete([completed, result, source = states[i].get(), i] () {
+			if (completed->exchange(true)) {
+				return;
+			}
+
+			if (std::exception_ptr exception = source->getException()) {
+				result->fail(exception);
+				return;
+			}
+
+			size_t index = i;
+			result->complete(std::move(index));
+		});
+	}
+
+	return {pool, result};
+}
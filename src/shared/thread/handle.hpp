@@ -0,0 +1,246 @@
+#pragma once
+
+#include "pool.hpp"
+#include <optional>
+
+/**
+ * Completion state of a task shared with its handles, continuations registered
+ * before the completion run on the thread that completes the task, the later ones right away
+ */
+class TaskState {
+
+	private:
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::vector<Task> continuations;
+		std::exception_ptr exception;
+		bool done = false;
+
+	protected:
+
+		/// Mark the state as completed and run the continuations, the value needs to be set before
+		void finish(std::exception_ptr exception);
+
+	public:
+
+		virtual ~TaskState() = default;
+
+		/// Call the function after the task completes, continuations should be short, to do more work enqueue it
+		void onComplete(Task continuation);
+
+		/// Like onComplete() but if the task already completed the function is not called and false is returned
+		bool addContinuation(Task& continuation);
+
+		/// Check if the task has already completed
+		bool isDone();
+
+		/// Block until the task completes, avoid calling this from within the pool's tasks
+		void wait();
+
+		/// Get the exception the task failed with, only valid after the task completed
+		std::exception_ptr getException();
+
+};
+
+/**
+ * Completion state with the value returned by the task
+ */
+template <typename T>
+class ValueState : public TaskState {
+
+	public:
+
+		std::optional<T> value;
+
+		void complete(T&& result) {
+			value.emplace(std::move(result));
+			finish(nullptr);
+		}
+
+		void fail(std::exception_ptr exception) {
+			finish(exception);
+		}
+
+		/// Call the function and complete the state with its result or exception
+		template <typename F>
+		void settle(F&& func) {
+			try {
+				complete(func());
+			} catch (...) {
+				fail(std::current_exception());
+			}
+		}
+
+};
+
+template <>
+class ValueState<void> : public TaskState {
+
+	public:
+
+		void complete() {
+			finish(nullptr);
+		}
+
+		void fail(std::exception_ptr exception) {
+			finish(exception);
+		}
+
+		template <typename F>
+		void settle(F&& func) {
+			try {
+				func();
+				complete();
+			} catch (...) {
+				fail(std::current_exception());
+			}
+		}
+
+};
+
+/**
+ * Lightweight handle of a task running on a TaskPool, unlike a std::future it allows to attach
+ * continuations that are scheduled when the task completes, so no thread needs to block waiting for it
+ */
+template <typename T = void>
+class TaskHandle {
+
+	private:
+
+		template <typename F>
+		struct ResultOf {
+			using type = std::decay_t<std::invoke_result_t<F&, const T&>>;
+		};
+
+		template <typename F> requires std::is_void_v<T>
+		struct ResultOf<F> {
+			using type = std::decay_t<std::invoke_result_t<F&>>;
+		};
+
+		TaskPool* pool;
+		std::shared_ptr<ValueState<T>> state;
+
+	public:
+
+		TaskHandle(TaskPool& pool, std::shared_ptr<ValueState<T>> state)
+		: pool(&pool), state(std::move(state)) {}
+
+		/// Check if the task has already completed
+		bool isDone() const {
+			return state->isDone();
+		}
+
+		/// Block until the task completes, avoid calling this from within the pool's tasks
+		void wait() const {
+			state->wait();
+		}
+
+		/// Block until the task completes and return its result, rethrows the exception the task failed with
+		decltype(auto) get() const {
+			state->wait();
+
+			if (std::exception_ptr exception = state->getException()) {
+				std::rethrow_exception(exception);
+			}
+
+			if constexpr (!std::is_void_v<T>) {
+				return static_cast<const T&>(*state->value);
+			}
+		}
+
+		/**
+		 * Schedule the function on the pool after this task completes, it's called with the
+		 * result of this task, if this task fails the function is skipped and the returned handle fails too
+		 */
+		template <typename F, typename R = typename ResultOf<F>::type>
+		TaskHandle<R> then(F func) const {
+			auto next = std::make_shared<ValueState<R>>();
+
+			// the continuation only schedules the work, so the completing thread isn't held up by it
+			state->onComplete([pool = pool, source = state, next, func = std::move(func)] () mutable {
+				if (std::exception_ptr exception = source->getException()) {
+					next->fail(exception);
+					return;
+				}
+
+				pool->enqueue([source = std::move(source), next = std::move(next), func = std::move(func)] () mutable {
+					next->settle([&] () {
+						if constexpr (std::is_void_v<T>) {
+							return func();
+						} else {
+							return func(*source->value);
+						}
+					});
+				});
+			});
+
+			return {*pool, next};
+		}
+
+		/// Get the completion state of this task, see tasks::whenAll()
+		std::shared_ptr<TaskState> getState() const {
+			return state;
+		}
+
+		/// Get the pool this task runs on
+		TaskPool& getPool() const {
+			return *pool;
+		}
+
+};
+
+/**
+ * Functions that create task handles and combine them into dependency graphs, a task
+ * that depends on others is only scheduled after they complete, nothing blocks in between
+ */
+namespace tasks {
+
+	/**
+	 * Enqueue the function on the pool and return a handle to its result, continuations run in the normal class
+	 */
+	template <typename F, typename R = std::decay_t<std::invoke_result_t<F&>>>
+	TaskHandle<R> spawn(TaskPool& pool, F func, TaskPriority priority = TaskPriority::NORMAL) {
+		auto state = std::make_shared<ValueState<R>>();
+
+		pool.enqueue([state, func = std::move(func)] () mutable {
+			state->settle(func);
+		}, priority);
+
+		return {pool, state};
+	}
+
+	/**
+	 * Returns a handle that completes after all the given tasks complete, it fails with the first
+	 * exception of the failed tasks, use as an explicit dependency edge: whenAll(pool, a, b).then(...)
+	 */
+	TaskHandle<> whenAll(TaskPool& pool, const std::vector<std::shared_ptr<TaskState>>& states);
+
+	/**
+	 * Returns a handle that completes after the first of the given tasks completes, with its index,
+	 * if that task failed the handle fails with the same exception
+	 */
+	TaskHandle<size_t> whenAny(TaskPool& pool, const std::vector<std::shared_ptr<TaskState>>& states);
+
+	template <typename... T>
+	TaskHandle<> whenAll(TaskPool& pool, const TaskHandle<T>&... handles) {
+		return whenAll(pool, {handles.getState()...});
+	}
+
+	template <typename... T>
+	TaskHandle<size_t> whenAny(TaskPool& pool, const TaskHandle<T>&... handles) {
+		return whenAny(pool, {handles.getState()...});
+	}
+
+	template <typename T>
+	TaskHandle<> whenAll(TaskPool& pool, const std::vector<TaskHandle<T>>& handles) {
+		std::vector<std::shared_ptr<TaskState>> states;
+
+		for (const TaskHandle<T>& handle : handles) {
+			states.push_back(handle.getState());
+		}
+
+		return whenAll(pool, states);
+	}
+
+}
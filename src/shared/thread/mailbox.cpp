@@ -4,10 +4,10 @@
 MailboxTaskDelegator::MailboxTaskDelegator(TaskPool& pool)
 : pool(pool) {}
 
-void MailboxTaskDelegator::enqueue(const Task& task) {
+void MailboxTaskDelegator::enqueue(Task task) {
 	mutex.lock();
 
-	pool.chained(task, [this] () {
+	pool.chained(std::move(task), [this] () {
 		mutex.unlock();
 	});
 }
@@ -24,7 +24,7 @@ class MailboxTaskDelegator {
 		 * if enqueue is called before the previous task is done
 		 * it will block until the previous task completes
 		 */
-		void enqueue(const Task& task);
+		void enqueue(Task task);
 
 		/**
 		 * Wait for the previously added task to complete,
@@ -0,0 +1,102 @@
+#include "parallel.hpp"
+
+namespace parallel {
+
+	/// Shared between the caller and the helper tasks, the helpers may outlive the call
+	struct RangeState {
+		std::atomic<size_t> next {0};
+		std::atomic<size_t> done {0};
+
+		size_t begin;
+		size_t end;
+		size_t grain;
+		size_t chunks;
+
+		void* context;
+		ChunkFunction function;
+
+		std::mutex mutex;
+		std::exception_ptr exception;
+
+		/// Execute the next chunk, returns false if there are none left
+		bool step() {
+			const size_t chunk = next.fetch_add(1, std::memory_order_relaxed);
+
+			if (chunk >= chunks) {
+				return false;
+			}
+
+			const size_t first = begin + chunk * grain;
+
+			try {
+				function(context, chunk, first, std::min(first + grain, end));
+			} catch (...) {
+				std::lock_guard lock {mutex};
+
+				if (!exception) {
+					exception = std::current_exception();
+				}
+			}
+
+			if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == chunks) {
+				done.notify_all();
+			}
+
+			return true;
+		}
+	};
+
+}
+
+size_t parallel::grainOf(const TaskPool& pool, size_t count, size_t grain) {
+	if (grain != 0) {
+		return grain;
+	}
+
+	const size_t chunks = (pool.size() + 1) * 4;
+	return std::max<size_t>((count + chunks - 1) / chunks, 1);
+}
+
+void parallel::run(TaskPool& pool, size_t begin, size_t end, size_t grain, void* context, ChunkFunction function) {
+	if (begin >= end) {
+		return;
+	}
+
+	const size_t size = grainOf(pool, end - begin, grain);
+	const size_t chunks = (end - begin + size - 1) / size;
+
+	// nothing to share, skip the allocation
+	if (chunks == 1) {
+		function(context, 0, begin, end);
+		return;
+	}
+
+	auto state = std::make_shared<RangeState>();
+	state->begin = begin;
+	state->end = end;
+	state->grain = size;
+	state->chunks = chunks;
+	state->context = context;
+	state->function = function;
+
+	// helpers that start after all chunks were taken exit right away
+	const size_t helpers = std::min(chunks - 1, pool.size());
+
+	for (size_t i = 0; i < helpers; i ++) {
+		// the caller is waiting for the chunks, so the helpers go before the regular tasks
+		pool.enqueue([state] () {
+			while (state->step());
+		}, TaskPriority::CRITICAL);
+	}
+
+	while (state->step());
+
+	// wait for the chunks taken by the helpers
+	for (size_t done = state->done.load(std::memory_order_acquire); done < chunks; done = state->done.load(std::memory_order_acquire)) {
+		state->done.wait(done, std::memory_order_acquire);
+	}
+
+	if (state->exception) {
+		std::rethrow_exception(state->exception);
+	}
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "pool.hpp"
+#include <optional>
+
+/**
+ * Data parallel loops over index ranges, the range is split into chunks that are taken
+ * by the pool workers and by the calling thread, so the caller works instead of blocking, and a call
+ * made from within a pool task can't deadlock, even if all the workers are busy
+ */
+namespace parallel {
+
+	using ChunkFunction = void (*) (void* context, size_t chunk, size_t begin, size_t end);
+
+	/// Minimal number of elements for which parallel::sort() splits the range
+	constexpr size_t SORT_THRESHOLD = 4096;
+
+	/**
+	 * Returns the number of elements in a chunk, with zero grain the size is picked
+	 * so that there are a few chunks per thread, which keeps the load balanced
+	 */
+	size_t grainOf(const TaskPool& pool, size_t count, size_t grain);
+
+	/**
+	 * Calls the function for each chunk of [begin, end), returns after all chunks complete,
+	 * the first exception thrown by the function is rethrown after that
+	 */
+	void run(TaskPool& pool, size_t begin, size_t end, size_t grain, void* context, ChunkFunction function);
+
+	/**
+	 * Calls func(begin, end) for each chunk of [begin, end), returns after all chunks complete
+	 *
+	 * @param grain number of elements per chunk, zero picks it automatically
+	 */
+	template <typename F>
+	void forEach(TaskPool& pool, size_t begin, size_t end, F&& func, size_t grain = 0) {
+		run(pool, begin, end, grain, (void*) &func, [] (void* context, size_t chunk, size_t first, size_t last) {
+			(*static_cast<std::remove_reference_t<F>*>(context))(first, last);
+		});
+	}
+
+	/**
+	 * Maps each chunk of [begin, end) with map(begin, end) and folds the results with combine(left, right),
+	 * the chunk results are combined in order, so the result doesn't depend on the timing even if combine isn't commutative
+	 *
+	 * @param grain number of elements per chunk, zero picks it automatically
+	 */
+	template <typename T, typename Map, typename Combine>
+	T reduce(TaskPool& pool, size_t begin, size_t end, T identity, Map&& map, Combine&& combine, size_t grain = 0) {
+		if (begin >= end) {
+			return identity;
+		}
+
+		const size_t size = grainOf(pool, end - begin, grain);
+		std::vector<std::optional<T>> partials((end - begin + size - 1) / size);
+
+		auto chunk = [&] (size_t index, size_t first, size_t last) {
+			partials[index].emplace(map(first, last));
+		};
+
+		run(pool, begin, end, size, &chunk, [] (void* context, size_t index, size_t first, size_t last) {
+			(*static_cast<decltype(chunk)*>(context))(index, first, last);
+		});
+
+		T result = std::move(identity);
+
+		for (std::optional<T>& partial : partials) {
+			result = combine(std::move(result), std::move(*partial));
+		}
+
+		return result;
+	}
+
+	/**
+	 * Sorts the range, the chunks are sorted in parallel and then merged in parallel pairs,
+	 * short ranges are sorted on the calling thread, the sort is not stable
+	 */
+	template <typename Iterator, typename Compare = std::less<>>
+	void sort(TaskPool& pool, Iterator first, Iterator last, Compare compare = {}) {
+		const size_t count = last - first;
+
+		if (count < SORT_THRESHOLD) {
+			std::sort(first, last, compare);
+			return;
+		}
+
+		// one chunk per thread, every chunk doubles the merge work
+		const size_t size = std::max((count + pool.size()) / (pool.size() + 1), SORT_THRESHOLD / 2);
+
+		forEach(pool, 0, count, [&] (size_t begin, size_t end) {
+			std::sort(first + begin, first + end, compare);
+		}, size);
+
+		for (size_t width = size; width < count; width *= 2) {
+			const size_t pairs = (count + width * 2 - 1) / (width * 2);
+
+			forEach(pool, 0, pairs, [&] (size_t begin, size_t end) {
+				for (size_t pair = begin; pair < end; pair ++) {
+					const size_t left = pair * width * 2;
+					const size_t middle = std::min(left + width, count);
+					const size_t right = std::min(left + width * 2, count);
+
+					std::inplace_merge(first + left, first + middle, first + right, compare);
+				}
+			}, 1);
+		}
+	}
+
+}
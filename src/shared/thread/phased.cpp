@@ -4,21 +4,18 @@
 PhasedTaskDelegator::PhasedTaskDelegator(TaskPool& pool)
 : pool(pool) {}
 
-void PhasedTaskDelegator::enqueue(const Task& task) {
-	{
-		std::unique_lock lock(mutex);
-		working ++;
-	}
+void PhasedTaskDelegator::begin() {
+	std::unique_lock lock(mutex);
+	working ++;
+}
 
-	// first execute task on the thread pool, after it completes run out lambda
-	pool.chained(task, [this] () {
-		std::unique_lock lock(mutex);
+void PhasedTaskDelegator::finish() {
+	std::unique_lock lock(mutex);
 
-		if (--working <= 0) {
-			lock.unlock();
-			condition.notify_one();
-		}
-	});
+	// notify under the lock, wait() may return and the delegator be destroyed as soon as the lock is released
+	if (--working <= 0) {
+		condition.notify_one();
+	}
 }
 
 void PhasedTaskDelegator::wait() {
@@ -27,4 +24,8 @@ void PhasedTaskDelegator::wait() {
 	while (working > 0) {
 		condition.wait(lock);
 	}
+}
+
+TaskPool& PhasedTaskDelegator::getPool() {
+	return pool;
 }
\ No newline at end of file
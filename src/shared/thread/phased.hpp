@@ -15,6 +15,9 @@ class PhasedTaskDelegator {
 		std::condition_variable condition;
 		TaskPool& pool;
 
+		void begin();
+		void finish();
+
 	public:
 
 		PhasedTaskDelegator(TaskPool& pool);
@@ -23,7 +26,16 @@ class PhasedTaskDelegator {
 		 * Enqueue task to the parent pool, all enqueue tasks will
 		 * need to finish before the wait() method will be unlocked.
 		 */
-		void enqueue(const Task& task);
+		template <typename F>
+		void enqueue(F task) {
+			begin();
+
+			// first execute task on the thread pool, after it completes finish it, someone
+			// is going to wait() for the phase, so the tasks go before the regular ones
+			pool.chained(std::move(task), [this] () {
+				finish();
+			}, TaskPriority::CRITICAL);
+		}
 
 		/**
 		 * Wait for all the previously added tasks to complete,
@@ -31,4 +43,9 @@ class PhasedTaskDelegator {
 		 */
 		void wait();
 
+		/**
+		 * Get the task pool this delegator adds tasks to
+		 */
+		TaskPool& getPool();
+
 };
\ No newline at end of file
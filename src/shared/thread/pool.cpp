@@ -1,68 +1,345 @@
-
 #include "pool.hpp"
 #include "shared/logger.hpp"
+#include "shared/arena.hpp"
 
 /*
  * TaskPool
  */
 
-void TaskPool::run() {
+void TaskPool::execute(Worker* worker, ManagedTask* task, size_t depth) {
+	Timer timer;
+
+	const double waited = task->call();
+	worker->counters.record(waited, timer.nanoseconds(), depth);
+
+	release(task);
+
+	// on pool threads every task is a frame of the thread arena
+	FrameArena::current().reset();
+}
+
+void TaskPool::run(Worker* worker) {
+	current_pool = this;
+	current_worker = worker;
 
-	ManagedTask task;
 	while (true) {
+		ManagedTask* task = take(worker);
+
+		if (task == nullptr) {
+			std::unique_lock lock {sleep_mutex};
+			sleeping ++;
+
+			// wait for a task to be enqueued or for the stop sequence to begin, enqueue() checks the
+			// sleeping counter after increasing the pending one, so one of the two always sees the other
+			condition.wait(lock, [this] { return stop || pending > 0; });
+			sleeping --;
+
+			if (stop && pending == 0) {
+				return;
+			}
+
+			continue;
+		}
+
+		// the queue depth is sampled as each task starts
+		execute(worker, task, pending.load(std::memory_order_relaxed));
+	}
+}
+
+void TaskPool::runLane(Worker* lane) {
+	current_pool = this;
+	current_worker = lane;
+
+	while (true) {
+		ManagedTask* task;
+		size_t depth;
+
 		{
-			std::unique_lock<std::mutex> lock(queue_mutex);
+			std::unique_lock lock {lane_mutex};
+			lane_condition.wait(lock, [this] { return lane_stop || !lane_tasks.empty(); });
+
+			if (lane_tasks.empty()) {
+				return;
+			}
+
+			task = lane_tasks.front();
+			depth = lane_tasks.size();
+			lane_tasks.pop();
+		}
+
+		execute(lane, task, depth);
+	}
+}
+
+ManagedTask* TaskPool::find(Worker* worker, size_t priority) {
+	{
+		std::unique_lock lock {injection_mutex};
+		std::queue<ManagedTask*>& queue = injected[priority];
+
+		if (!queue.empty()) {
+			ManagedTask* task = queue.front();
+			queue.pop();
+			worker->counters.injected.fetch_add(1, std::memory_order_relaxed);
+			return task;
+		}
+	}
 
-			// wait for task to appear in tasks queue or for the stop sequence to begin
-			condition.wait(lock, [this] { return this->stop || !this->tasks.empty(); });
-			if (stop && tasks.empty()) return;
+	// start at a random victim, so the thieves don't all fight over the first worker
+	worker->seed ^= worker->seed << 13;
+	worker->seed ^= worker->seed >> 17;
+	worker->seed ^= worker->seed << 5;
 
-			task = std::move(tasks.front());
-			tasks.pop();
+	const size_t count = workers.size();
+	const size_t start = worker->seed % count;
+
+	for (size_t i = 0; i < count; i ++) {
+		Worker* victim = workers[(start + i) % count].get();
+
+		if (victim == worker) {
+			continue;
 		}
 
-		task.call();
+		if (ManagedTask* task = victim->deques[priority].steal()) {
+			worker->counters.stolen.fetch_add(1, std::memory_order_relaxed);
+			return task;
+		}
 	}
 
+	return nullptr;
+}
+
+ManagedTask* TaskPool::take(Worker* worker) {
+	for (int spin = 0; spin < SPINS; spin ++) {
+		if (pending == 0) {
+			return nullptr;
+		}
+
+		// the most urgent class first, the counters let the worker skip the empty classes without touching their queues
+		for (size_t priority = 0; priority < PRIORITIES; priority ++) {
+			if (queued[priority] == 0) {
+				continue;
+			}
+
+			ManagedTask* task = worker->deques[priority].pop();
+
+			if (task == nullptr) {
+				task = find(worker, priority);
+			}
+
+			if (task != nullptr) {
+				queued[priority] --;
+				pending --;
+				return task;
+			}
+		}
+
+		std::this_thread::yield();
+	}
+
+	return nullptr;
+}
+
+void TaskPool::push(ManagedTask* task, TaskPriority priority) {
+	const size_t index = static_cast<size_t>(priority);
+
+	if (priority == TaskPriority::BACKGROUND && !lanes.empty()) {
+		{
+			std::unique_lock lock {lane_mutex};
+
+			if (lane_stop) {
+				release(task);
+				FAULT("Unable to add task to a stopped pool!");
+			}
+
+			lane_tasks.push(task);
+		}
+
+		lane_condition.notify_one();
+		return;
+	}
+
+	// counted before it's visible, so that the thief that takes it can't decrement the counter first
+	pending ++;
+	queued[index] ++;
+
+	if (current_pool == this && !current_worker->lane) {
+		current_worker->deques[index].push(task);
+	} else {
+		std::unique_lock lock {injection_mutex};
+
+		// don't allow enqueueing after stopping the pool
+		if (stop) {
+			queued[index] --;
+			pending --;
+
+			// the lanes outlive the workers, so the last background tasks run the work they enqueue themselves
+			if (current_pool == this) {
+				lock.unlock();
+				task->call();
+				release(task);
+				return;
+			}
+
+			release(task);
+			FAULT("Unable to add task to a stopped pool!");
+		}
+
+		injected[index].push(task);
+	}
+
+	if (sleeping > 0) {
+		std::unique_lock lock {sleep_mutex};
+		condition.notify_one();
+	}
+}
+
+/// Freed task nodes of the calling thread, a node goes back to the thread that ran it
+struct TaskCache {
+	static constexpr size_t CAPACITY = 1024;
+
+	std::vector<void*> blocks;
+
+	~TaskCache() {
+		for (void* block : blocks) {
+			::operator delete(block);
+		}
+	}
+};
+
+static thread_local TaskCache cache;
+
+ManagedTask* TaskPool::allocate(Task&& task) {
+	void* block;
+
+	if (cache.blocks.empty()) {
+		block = ::operator new(sizeof(ManagedTask));
+	} else {
+		block = cache.blocks.back();
+		cache.blocks.pop_back();
+	}
+
+	return new (block) ManagedTask {std::move(task)};
+}
+
+void TaskPool::release(ManagedTask* task) {
+	task->~ManagedTask();
+
+	// external threads only enqueue, so their nodes pile up on the workers, don't keep all of them
+	if (cache.blocks.size() >= TaskCache::CAPACITY) {
+		::operator delete(task);
+		return;
+	}
+
+	cache.blocks.push_back(task);
 }
 
 size_t TaskPool::optimal() {
 	return std::max((int) std::thread::hardware_concurrency() - 1, 1);
 }
 
-TaskPool::TaskPool(size_t count)
-: stop(false) {
-	out::info("Created thread pool with %d workers", count);
+size_t TaskPool::size() const {
+	return workers.size();
+}
+
+TaskPool::TaskPool(size_t count, size_t io_lanes)
+: stop(false), pending(0), queued(), sleeping(0), lane_stop(false), statistics_start(std::chrono::steady_clock::now().time_since_epoch().count()) {
+	out::info("Created thread pool with %d workers and %d I/O lanes", count, io_lanes);
+
+	for (size_t i = 0; i < count; i ++) {
+		Worker* worker = workers.emplace_back(std::make_unique<Worker>()).get();
+		worker->seed = i * 2654435761u + 1;
+	}
+
+	// start the threads only after all the workers exist, as they steal from each other
+	for (auto& worker : workers) {
+		worker->thread = std::thread {&TaskPool::run, this, worker.get()};
+	}
 
-	while (count --> 0) {
-		workers.emplace_back(&TaskPool::run, this);
+	for (size_t i = 0; i < io_lanes; i ++) {
+		Worker* lane = lanes.emplace_back(std::make_unique<Worker>()).get();
+		lane->lane = true;
+		lane->thread = std::thread {&TaskPool::runLane, this, lane};
 	}
 }
 
 TaskPool::~TaskPool() {
 	{
-		std::unique_lock<std::mutex> lock(queue_mutex);
+		std::unique_lock lock {injection_mutex};
+		std::unique_lock sleep_lock {sleep_mutex};
 		stop = true;
 	}
 
 	this->condition.notify_all();
 
 	for (auto& worker : this->workers) {
-		worker.join();
+		worker->thread.join();
 	}
-}
 
-void TaskPool::enqueue(const Task& task) {
+	// the lanes stop only after the workers, so the last tasks on the workers can still enqueue background work
 	{
-		std::unique_lock<std::mutex> lock(queue_mutex);
+		std::unique_lock lock {lane_mutex};
+		lane_stop = true;
+	}
 
-		// don't allow enqueueing after stopping the pool
-		if (stop) {
-			FAULT("Unable to add task to a stopped pool!");
-		}
+	this->lane_condition.notify_all();
+
+	for (auto& lane : this->lanes) {
+		lane->thread.join();
+	}
+}
+
+void TaskPool::enqueue(Task task, TaskPriority priority) {
+	push(allocate(std::move(task)), priority);
+}
+
+bool TaskPool::isWorker() const {
+	return current_pool == this;
+}
+
+PoolStatistics TaskPool::getStatistics() const {
+	PoolStatistics statistics;
 
-		tasks.emplace(task);
+	const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+	const double period = std::chrono::duration<double, std::nano> {std::chrono::steady_clock::duration {now - statistics_start.load()}}.count();
+
+	statistics.uptime = period / 1'000'000;
+
+	auto collect = [&] (const Worker& worker, bool lane) {
+		const WorkerCounters& counters = worker.counters;
+		PoolStatistics::Worker& entry = statistics.workers.emplace_back();
+
+		entry.lane = lane;
+		entry.executed = counters.executed.load(std::memory_order_relaxed);
+		entry.stolen = counters.stolen.load(std::memory_order_relaxed);
+		entry.injected = counters.injected.load(std::memory_order_relaxed);
+		entry.wait_time = counters.wait_time.load(std::memory_order_relaxed) / 1'000'000.0;
+		entry.busy_time = counters.busy_time.load(std::memory_order_relaxed) / 1'000'000.0;
+		entry.utilization = period > 0 ? std::min(entry.busy_time / statistics.uptime, 1.0) : 0;
+
+		statistics.wait.add(counters.wait);
+		statistics.execution.add(counters.execution);
+		statistics.depth.add(counters.depth);
+	};
+
+	for (const auto& worker : workers) {
+		collect(*worker, false);
+	}
+
+	for (const auto& lane : lanes) {
+		collect(*lane, true);
 	}
 
-	condition.notify_one();
-}
\ No newline at end of file
+	return statistics;
+}
+
+void TaskPool::resetStatistics() {
+	for (auto& worker : workers) {
+		worker->counters.reset();
+	}
+
+	for (auto& lane : lanes) {
+		lane->counters.reset();
+	}
+
+	statistics_start = std::chrono::steady_clock::now().time_since_epoch().count();
+}
@@ -7,27 +7,86 @@
 #include <future>
 
 #include "task.hpp"
+#include "steal.hpp"
+#include "stats.hpp"
 
 /**
- * A basic thread pool implementation with
- * support for std::futures
+ * A work-stealing thread pool with support for std::futures, every worker
+ * has its own deques, tasks enqueued by a worker go to its own deque (and run in a LIFO order),
+ * idle workers steal from the other deques, tasks from other threads go through a shared injection queue,
+ * each priority class has its own queues, so a burst of background work can't delay the critical tasks
  */
 class TaskPool {
 
+	public:
+
+		static constexpr size_t PRIORITIES = 3;
+
 	private:
 
-		bool stop;
+		struct Worker {
+			StealingDeque<ManagedTask> deques[PRIORITIES];
+			std::thread thread;
+			uint32_t seed;
+			WorkerCounters counters;
+
+			// lanes have deques too, but nothing takes from them, so their tasks enqueue through the injection queue
+			bool lane = false;
+		};
+
+		/// How many times an idle worker looks for work before going to sleep
+		static constexpr int SPINS = 64;
+
+		inline static thread_local TaskPool* current_pool = nullptr;
+		inline static thread_local Worker* current_worker = nullptr;
+
+		std::atomic<bool> stop;
+		std::vector<std::unique_ptr<Worker>> workers;
+
+		// tasks enqueued from outside of the pool
+		std::mutex injection_mutex;
+		std::queue<ManagedTask*> injected[PRIORITIES];
 
-		std::vector<std::thread> workers;
-		std::mutex queue_mutex;
-		std::queue<ManagedTask> tasks;
+		// number of tasks waiting in all the queues, workers only sleep when it's zero
+		std::atomic<size_t> pending;
+		std::atomic<size_t> queued[PRIORITIES];
+		std::atomic<size_t> sleeping;
+		std::mutex sleep_mutex;
 		std::condition_variable condition;
 
-		void run();
+		// dedicated threads for background tasks, they never run the other classes
+		std::vector<std::unique_ptr<Worker>> lanes;
+		std::mutex lane_mutex;
+		std::queue<ManagedTask*> lane_tasks;
+		std::condition_variable lane_condition;
+		bool lane_stop;
+
+		// start of the statistics period, in steady clock nanoseconds
+		std::atomic<int64_t> statistics_start;
+
+		void run(Worker* worker);
+		void runLane(Worker* lane);
+
+		/// Take a task from the injection queue or steal it from one of the other workers
+		ManagedTask* find(Worker* worker, size_t priority);
+		ManagedTask* take(Worker* worker);
+
+		void push(ManagedTask* task, TaskPriority priority);
+
+		/// Execute the task and record its statistics
+		static void execute(Worker* worker, ManagedTask* task, size_t depth);
+
+		/// Task nodes are recycled through a small cache of the calling thread
+		static ManagedTask* allocate(Task&& task);
+		static void release(ManagedTask* task);
 
 	public:
 
-		TaskPool(size_t count = TaskPool::optimal());
+		/**
+		 * Creates a pool with the given number of workers, and of dedicated I/O lanes, without
+		 * the lanes background tasks run on the workers when there is nothing more urgent to do
+		 */
+		TaskPool(size_t count = TaskPool::optimal(), size_t io_lanes = 0);
 		~TaskPool();
 
 		/**
@@ -37,14 +96,37 @@ class TaskPool {
 		static size_t optimal();
 
 		/**
-		 * Enqueue a task for execution by one of the threads
-		 * on this thread pool, the tasks start execution in a FIFO order
+		 * Get the number of worker threads in this pool, without the I/O lanes
+		 */
+		size_t size() const;
+
+		/**
+		 * Enqueue a task for execution by one of the threads on this thread pool,
+		 * tasks from outside of the pool start execution in a FIFO order, tasks
+		 * enqueued from within the pool's own tasks prefer the same worker and run in a LIFO order,
+		 * no task starts while a task of a more urgent class waits (but running tasks are not interrupted)
+		 */
+		void enqueue(Task task, TaskPriority priority = TaskPriority::NORMAL);
+
+		/**
+		 * Check if the calling thread is one of the workers or I/O lanes of this pool
 		 */
-		void enqueue(const Task& task);
+		bool isWorker() const;
+
+		/**
+		 * Get the statistics of the tasks executed since the pool was created or the last reset,
+		 * the workers keep running while they are collected, so the numbers are not an exact snapshot
+		 */
+		PoolStatistics getStatistics() const;
+
+		/**
+		 * Start a new statistics period
+		 */
+		void resetStatistics();
 
 	public:
 
-		template <typename Func, typename Arg, typename... Args>
+		template <typename Func, typename Arg, typename... Args> requires (!std::same_as<Arg, TaskPriority>)
 		void enqueue(Func func, Arg arg, Args... args) {
 			this->enqueue(std::bind(func, arg, args...));
 		}
@@ -55,10 +137,11 @@ class TaskPool {
 		 *
 		 * @param first the first task to execute
 		 * @param then the seconds task to execute on the same thread
+		 * @param priority the class of the combined task
 		 */
 		template <typename First, typename Then>
-		void chained(const First& first, const Then& then) {
-			enqueue([first, then] () {
+		void chained(First first, Then then, TaskPriority priority = TaskPriority::NORMAL) {
+			enqueue([first = std::move(first), then = std::move(then)] () mutable {
 				try {
 					first();
 				} catch (std::runtime_error& exception) {
@@ -68,28 +151,31 @@ class TaskPool {
 				}
 
 				then();
-			});
+			}, priority);
 		}
 
 		/**
 		 * Wraps the given function in a std::future and returns it
-		 * while enqueuing the task for execution on this thread pool
+		 * while enqueuing the task for execution on this thread pool,
+		 * the promise is moved into the task, so no extra allocation is needed for it
 		 */
 		template <typename F, typename T = typename std::invoke_result<F>::type>
-		std::future<T> defer(const F& task) {
-			auto* raw_promise = new std::promise<T>();
-			std::future<T> future = raw_promise->get_future();
-
-			// kill me
-			enqueue([task, raw_promise] () {
-				std::unique_ptr<std::promise<T>> promise(raw_promise);
+		std::future<T> defer(F task, TaskPriority priority = TaskPriority::NORMAL) {
+			std::promise<T> promise;
+			std::future<T> future = promise.get_future();
 
+			enqueue([task = std::move(task), promise = std::move(promise)] () mutable {
 				try {
-					promise->set_value(task());
+					if constexpr (std::is_void_v<T>) {
+						task();
+						promise.set_value();
+					} else {
+						promise.set_value(task());
+					}
 				} catch (...) {
-					promise->set_exception(std::current_exception());
+					promise.set_exception(std::current_exception());
 				}
-			});
+			}, priority);
 
 			return future;
 		}
@@ -0,0 +1,156 @@
+#include "stats.hpp"
+
+/*
+ * TaskHistogram
+ */
+
+void TaskHistogram::collect(std::array<uint64_t, BUCKETS>& into) const {
+	for (size_t i = 0; i < BUCKETS; i ++) {
+		into[i] += counts[i].load(std::memory_order_relaxed);
+	}
+}
+
+void TaskHistogram::reset() {
+	for (std::atomic<uint64_t>& count : counts) {
+		count.store(0, std::memory_order_relaxed);
+	}
+}
+
+/*
+ * WorkerCounters
+ */
+
+void WorkerCounters::record(uint64_t waited, uint64_t took, size_t queued) {
+	auto increment = [] (std::atomic<uint64_t>& counter, uint64_t value) {
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	};
+
+	increment(executed, 1);
+	increment(wait_time, waited);
+	increment(busy_time, took);
+
+	wait.add(waited);
+	execution.add(took);
+	depth.add(queued);
+}
+
+void WorkerCounters::reset() {
+	executed.store(0, std::memory_order_relaxed);
+	stolen.store(0, std::memory_order_relaxed);
+	injected.store(0, std::memory_order_relaxed);
+	wait_time.store(0, std::memory_order_relaxed);
+	busy_time.store(0, std::memory_order_relaxed);
+
+	wait.reset();
+	execution.reset();
+	depth.reset();
+}
+
+/*
+ * HistogramSummary
+ */
+
+uint64_t HistogramSummary::percentile(double fraction) const {
+	const uint64_t target = std::ceil(count * std::clamp(fraction, 0.0, 1.0));
+	uint64_t seen = 0;
+
+	for (size_t i = 0; i < buckets.size(); i ++) {
+		seen += buckets[i];
+
+		if (seen >= target && seen > 0) {
+			return i == 0 ? 0 : (uint64_t) 1 << i;
+		}
+	}
+
+	return 0;
+}
+
+void HistogramSummary::add(const TaskHistogram& histogram) {
+	histogram.collect(buckets);
+	count = std::accumulate(buckets.begin(), buckets.end(), (uint64_t) 0);
+}
+
+/*
+ * PoolStatistics
+ */
+
+uint64_t PoolStatistics::getExecuted() const {
+	return std::accumulate(workers.begin(), workers.end(), (uint64_t) 0, [] (uint64_t sum, const Worker& worker) {
+		return sum + worker.executed;
+	});
+}
+
+uint64_t PoolStatistics::getStolen() const {
+	return std::accumulate(workers.begin(), workers.end(), (uint64_t) 0, [] (uint64_t sum, const Worker& worker) {
+		return sum + worker.stolen;
+	});
+}
+
+double PoolStatistics::getUtilization() const {
+	double sum = 0;
+	size_t count = 0;
+
+	for (const Worker& worker : workers) {
+		if (!worker.lane) {
+			sum += worker.utilization;
+			count ++;
+		}
+	}
+
+	return count ? sum / count : 0;
+}
+
+static void writeHistogram(std::ostringstream& json, const char* name, const HistogramSummary& summary) {
+	json << "\"" << name << "\":{\"count\":" << summary.count;
+	json << ",\"p50\":" << summary.percentile(0.5);
+	json << ",\"p90\":" << summary.percentile(0.9);
+	json << ",\"p99\":" << summary.percentile(0.99);
+	json << ",\"buckets\":[";
+
+	// trailing empty buckets are left out
+	size_t used = summary.buckets.size();
+
+	while (used > 0 && summary.buckets[used - 1] == 0) {
+		used --;
+	}
+
+	for (size_t i = 0; i < used; i ++) {
+		json << (i ? "," : "") << summary.buckets[i];
+	}
+
+	json << "]}";
+}
+
+std::string PoolStatistics::toJson() const {
+	std::ostringstream json;
+
+	json << "{\"uptime\":" << uptime;
+	json << ",\"executed\":" << getExecuted();
+	json << ",\"stolen\":" << getStolen();
+	json << ",\"utilization\":" << getUtilization();
+	json << ",\"workers\":[";
+
+	for (size_t i = 0; i < workers.size(); i ++) {
+		const Worker& worker = workers[i];
+
+		json << (i ? "," : "") << "{\"lane\":" << (worker.lane ? "true" : "false");
+		json << ",\"executed\":" << worker.executed;
+		json << ",\"stolen\":" << worker.stolen;
+		json << ",\"injected\":" << worker.injected;
+		json << ",\"wait_time\":" << worker.wait_time;
+		json << ",\"busy_time\":" << worker.busy_time;
+		json << ",\"utilization\":" << worker.utilization << "}";
+	}
+
+	json << "],";
+
+	// histogram buckets are in nanoseconds, or in tasks for the queue depth
+	writeHistogram(json, "wait_ns", wait);
+	json << ",";
+	writeHistogram(json, "execution_ns", execution);
+	json << ",";
+	writeHistogram(json, "queue_depth", depth);
+	json << "}";
+
+	return json.str();
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "external.hpp"
+
+/**
+ * Histogram with power of two buckets, bucket i counts the values in [2^(i-1), 2^i),
+ * only one thread records into it, but any thread can read it while that happens
+ */
+class TaskHistogram {
+
+	public:
+
+		static constexpr size_t BUCKETS = 48;
+
+	private:
+
+		std::array<std::atomic<uint64_t>, BUCKETS> counts {};
+
+	public:
+
+		/// Record a single value, can only be called by the owning thread
+		void add(uint64_t value) {
+			const size_t bucket = std::min<size_t>(std::bit_width(value), BUCKETS - 1);
+			counts[bucket].store(counts[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+
+		/// Add the counts of this histogram into the array
+		void collect(std::array<uint64_t, BUCKETS>& into) const;
+
+		void reset();
+
+};
+
+/**
+ * Counters of a single pool worker, only the worker writes them
+ */
+struct alignas(64) WorkerCounters {
+
+	std::atomic<uint64_t> executed {0};
+	std::atomic<uint64_t> stolen {0};
+	std::atomic<uint64_t> injected {0};
+	std::atomic<uint64_t> wait_time {0};
+	std::atomic<uint64_t> busy_time {0};
+
+	TaskHistogram wait;
+	TaskHistogram execution;
+	TaskHistogram depth;
+
+	/// Record a task executed by the owning worker, times are in nanoseconds
+	void record(uint64_t waited, uint64_t took, size_t queued);
+
+	void reset();
+
+};
+
+/**
+ * Summary of a histogram, times are in nanoseconds
+ */
+struct HistogramSummary {
+
+	std::array<uint64_t, TaskHistogram::BUCKETS> buckets {};
+	uint64_t count = 0;
+
+	/// Get the upper bound of the bucket with the given percentile (0 to 1) of the values
+	uint64_t percentile(double fraction) const;
+
+	void add(const TaskHistogram& histogram);
+
+};
+
+/**
+ * Snapshot of the pool statistics, see TaskPool::getStatistics()
+ */
+struct PoolStatistics {
+
+	struct Worker {
+		bool lane;
+		uint64_t executed;
+		uint64_t stolen;
+		uint64_t injected;
+		double wait_time;
+		double busy_time;
+		double utilization;
+	};
+
+	double uptime;
+	std::vector<Worker> workers;
+
+	HistogramSummary wait;
+	HistogramSummary execution;
+	HistogramSummary depth;
+
+	/// Get the number of tasks executed by all the workers
+	uint64_t getExecuted() const;
+
+	/// Get the number of tasks taken from the deques of other workers
+	uint64_t getStolen() const;
+
+	/// Get the average fraction of the time the workers (without the I/O lanes) spent executing tasks
+	double getUtilization() const;
+
+	/// Write the statistics as a JSON object, times in milliseconds unless stated otherwise
+	std::string toJson() const;
+
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "external.hpp"
+
+/**
+ * Lock-free Chase-Lev work-stealing deque of pointers, the owning thread pushes and pops
+ * at the bottom (LIFO), while any other thread can steal from the top (FIFO),
+ * the ring grows as needed, old rings are only freed with the deque as thieves may still read them
+ */
+template <typename T>
+class StealingDeque {
+
+	private:
+
+		struct Ring {
+			const int64_t capacity;
+			std::unique_ptr<std::atomic<T*>[]> slots;
+
+			Ring(int64_t capacity)
+			: capacity(capacity), slots(new std::atomic<T*>[capacity]) {}
+
+			T* get(int64_t index) const {
+				return slots[index & (capacity - 1)].load(std::memory_order_relaxed);
+			}
+
+			void put(int64_t index, T* value) {
+				slots[index & (capacity - 1)].store(value, std::memory_order_relaxed);
+			}
+		};
+
+		alignas(64) std::atomic<int64_t> top {0};
+		alignas(64) std::atomic<int64_t> bottom {0};
+		std::atomic<Ring*> ring;
+
+		// owner only, keeps the replaced rings alive
+		std::vector<std::unique_ptr<Ring>> rings;
+
+		Ring* grow(Ring* old, int64_t first, int64_t last) {
+			Ring* bigger = rings.emplace_back(std::make_unique<Ring>(old->capacity * 2)).get();
+
+			for (int64_t i = first; i < last; i ++) {
+				bigger->put(i, old->get(i));
+			}
+
+			ring.store(bigger, std::memory_order_release);
+			return bigger;
+		}
+
+	public:
+
+		/// Capacity needs to be a power of two
+		StealingDeque(int64_t capacity = 256) {
+			ring.store(rings.emplace_back(std::make_unique<Ring>(capacity)).get(), std::memory_order_relaxed);
+		}
+
+		StealingDeque(const StealingDeque&) = delete;
+
+		/// Push a value to the bottom, can only be called by the owner
+		void push(T* value) {
+			const int64_t last = bottom.load(std::memory_order_relaxed);
+			const int64_t first = top.load(std::memory_order_acquire);
+			Ring* current = ring.load(std::memory_order_relaxed);
+
+			if (last - first >= current->capacity) {
+				current = grow(current, first, last);
+			}
+
+			current->put(last, value);
+			bottom.store(last + 1, std::memory_order_release);
+		}
+
+		/// Pop the most recently pushed value, can only be called by the owner, returns nullptr if empty
+		T* pop() {
+			const int64_t last = bottom.load(std::memory_order_relaxed) - 1;
+			Ring* current = ring.load(std::memory_order_relaxed);
+
+			// the sequentially consistent pair orders the reservation of the bottom against the thieves
+			bottom.store(last, std::memory_order_seq_cst);
+			int64_t first = top.load(std::memory_order_seq_cst);
+
+			if (first > last) {
+				bottom.store(last + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			T* value = current->get(last);
+
+			// the last value, race the thieves for it
+			if (first == last) {
+				if (!top.compare_exchange_strong(first, first + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+					value = nullptr;
+				}
+
+				bottom.store(last + 1, std::memory_order_relaxed);
+			}
+
+			return value;
+		}
+
+		/// Steal the least recently pushed value, can be called by any thread, returns nullptr if empty or lost a race
+		T* steal() {
+			int64_t first = top.load(std::memory_order_seq_cst);
+			const int64_t last = bottom.load(std::memory_order_seq_cst);
+
+			if (first >= last) {
+				return nullptr;
+			}
+
+			T* value = ring.load(std::memory_order_acquire)->get(first);
+
+			if (!top.compare_exchange_strong(first, first + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				return nullptr;
+			}
+
+			return value;
+		}
+
+		/// Get the approximate number of values in the deque
+		size_t size() const {
+			const int64_t count = bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed);
+			return count > 0 ? count : 0;
+		}
+
+};
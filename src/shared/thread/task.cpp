@@ -3,19 +3,28 @@
 
 #include <shared/logger.hpp>
 
+/*
+ * Task
+ */
+
+void Task::empty() {
+	FAULT("Unable to call an empty task!");
+}
+
 /*
  * ManagedTask
  */
 
-ManagedTask::ManagedTask(const Task& task)
-: task(task), timer() {}
+ManagedTask::ManagedTask(Task&& task)
+: task(std::move(task)), timer() {}
 
-void ManagedTask::call() const {
-	double millis = timer.milliseconds();
+double ManagedTask::call() const {
+	const double nanos = timer.nanoseconds();
 
-	if (millis > 200) {
-		out::warn("Is the system overloaded? Task waited %dms before starting execution!", (int) millis);
+	if (nanos > 200'000'000) {
+		out::warn("Is the system overloaded? Task waited %dms before starting execution!", (int) (nanos / 1'000'000));
 	}
 
 	task();
+	return nanos;
 }
\ No newline at end of file
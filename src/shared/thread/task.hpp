@@ -2,11 +2,135 @@
 
 #include "external.hpp"
 #include "shared/timer.hpp"
+#include <cstddef>
 
-using Task = std::function<void()>;
+/**
+ * Move-only type erased void() callable, callables that fit in the inline
+ * buffer are stored in the task itself, so creating and moving most tasks doesn't allocate
+ */
+class Task {
+
+	public:
+
+		static constexpr size_t INLINE_SIZE = 48;
+
+	private:
+
+		struct Operations {
+			void (*invoke) (void* callable);
+			void (*relocate) (void* from, void* to);
+			void (*destroy) (void* callable);
+		};
+
+		template <typename F>
+		static constexpr bool fitsInline() {
+			return sizeof(F) <= INLINE_SIZE && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+		}
+
+		/// Inline callables live in the storage, others only keep a pointer to them there
+		template <typename F>
+		static const Operations* operationsOf() {
+			if constexpr (fitsInline<F>()) {
+				static constexpr Operations operations {
+					[] (void* callable) { (*static_cast<F*>(callable))(); },
+					[] (void* from, void* to) { new (to) F(std::move(*static_cast<F*>(from))); static_cast<F*>(from)->~F(); },
+					[] (void* callable) { static_cast<F*>(callable)->~F(); }
+				};
+
+				return &operations;
+			} else {
+				static constexpr Operations operations {
+					[] (void* callable) { (**static_cast<F**>(callable))(); },
+					[] (void* from, void* to) { *static_cast<F**>(to) = *static_cast<F**>(from); },
+					[] (void* callable) { delete *static_cast<F**>(callable); }
+				};
+
+				return &operations;
+			}
+		}
+
+		const Operations* operations = nullptr;
+		alignas(std::max_align_t) mutable unsigned char storage[INLINE_SIZE];
+
+		void reset() {
+			if (operations) {
+				operations->destroy(storage);
+				operations = nullptr;
+			}
+		}
+
+		/// Report a call of an empty (or moved-from) task, kept out of line so that calls stay small
+		[[noreturn]] static void empty();
+
+	public:
+
+		Task() = default;
+
+		template <typename F> requires (!std::same_as<std::decay_t<F>, Task> && std::invocable<std::decay_t<F>&>)
+		Task(F&& func) {
+			using V = std::decay_t<F>;
+
+			if constexpr (fitsInline<V>()) {
+				new (storage) V(std::forward<F>(func));
+			} else {
+				*reinterpret_cast<V**>(storage) = new V(std::forward<F>(func));
+			}
+
+			operations = operationsOf<V>();
+		}
+
+		Task(Task&& other) noexcept {
+			if (other.operations) {
+				other.operations->relocate(other.storage, storage);
+				operations = std::exchange(other.operations, nullptr);
+			}
+		}
+
+		Task& operator=(Task&& other) noexcept {
+			if (this != &other) {
+				reset();
+
+				if (other.operations) {
+					other.operations->relocate(other.storage, storage);
+					operations = std::exchange(other.operations, nullptr);
+				}
+			}
+
+			return *this;
+		}
+
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+
+		~Task() {
+			reset();
+		}
+
+		void operator()() const {
+			if (!operations) [[unlikely]] {
+				empty();
+			}
+
+			operations->invoke(storage);
+		}
+
+		explicit operator bool() const {
+			return operations != nullptr;
+		}
+
+};
+
+/**
+ * Scheduling class of a task, workers always take the tasks of the most urgent class first
+ */
+enum struct TaskPriority : uint8_t {
+	CRITICAL = 0,   ///< work something in the current frame waits for
+	NORMAL = 1,     ///< default class
+	BACKGROUND = 2, ///< long running work such as file loading and decoding, runs on the I/O lanes if the pool has them
+};
 
 /**
- * A wrapper around a std::function that allows
+ * A wrapper around a Task that allows
  * TaskPool to attach additional information to tasks
  */
 class ManagedTask {
@@ -19,8 +143,9 @@ class ManagedTask {
 	public:
 
 		ManagedTask() = default;
-		ManagedTask(const Task& task);
+		ManagedTask(Task&& task);
 
-		void call() const;
+		/// Call the task, returns the time it waited for its execution in nanoseconds
+		double call() const;
 
-};
\ No newline at end of file
+};
@@ -4,12 +4,23 @@
 // checklight include
 #include <engine/board.hpp>
 #include <engine/boardManager.hpp>
+#include <engine/snapshot.hpp>
+#include <engine/prefab.hpp>
+#include <engine/headless.hpp>
 #include <gui/gui.hpp>
 #include <render/render.hpp>
 
 #include "shared/args.hpp"
 #include "shared/pyramid.hpp"
 #include "shared/weighed.hpp"
+#include "shared/slotmap.hpp"
+#include "shared/slab.hpp"
+#include "shared/arena.hpp"
+#include "shared/thread/graph.hpp"
+#include "shared/thread/bus.hpp"
+#include "shared/thread/parallel.hpp"
+#include "shared/thread/handle.hpp"
+#include "shared/thread/coroutine.hpp"
 
 BEGIN(VSTL_MODE_LENIENT)
 
@@ -126,6 +137,618 @@ TEST(util_weighed_set_repeated) {
 	CHECK(set.size(), 3);
 };
 
+TEST(util_slot_map) {
+	SlotMap<int> map;
+	ASSERT(map.empty());
+
+	Handle<int> a = map.insert(1);
+	Handle<int> b = map.insert(2);
+	CHECK(map.size(), 2);
+	CHECK(*map.get(a), 1);
+	CHECK(*map.get(b), 2);
+
+	ASSERT(map.remove(a));
+	ASSERT(!map.remove(a));
+	CHECK(map.get(a), nullptr);
+
+	// the slot is reused, but the old handle stays expired
+	Handle<int> c = map.insert(3);
+	CHECK(c.index, a.index);
+	CHECK(map.get(a), nullptr);
+	CHECK(*map.get(c), 3);
+	CHECK(map.size(), 2);
+
+	int sum = 0;
+	map.forEach([&] (int value) { sum += value; });
+	CHECK(sum, 5);
+
+	map.clear();
+	ASSERT(map.empty());
+	ASSERT(!map.contains(b));
+	ASSERT(!map.contains(c));
+};
+
+TEST(util_slab_allocator) {
+	struct Bullet {
+		float x, y, z;
+	};
+
+	auto stats = [] () {
+		for (const SlabStatistics& statistics : SlabPool::getAllStatistics()) {
+			if (statistics.name.ends_with("Bullet")) return statistics;
+		}
+
+		return SlabStatistics {};
+	};
+
+	std::vector<std::shared_ptr<Bullet>> bullets;
+
+	for (int i = 0; i < 100; i ++) {
+		bullets.push_back(std::allocate_shared<Bullet>(SlabAllocator<Bullet> {}));
+	}
+
+	CHECK(stats().live, 100);
+	CHECK(stats().peak, 100);
+
+	Bullet* freed = bullets.back().get();
+	bullets.pop_back();
+	CHECK(stats().live, 99);
+
+	// freed blocks are recycled
+	bullets.push_back(std::allocate_shared<Bullet>(SlabAllocator<Bullet> {}));
+	CHECK(bullets.back().get(), freed);
+
+	bullets.clear();
+	CHECK(stats().live, 0);
+	CHECK(stats().peak, 100);
+};
+
+TEST(util_job_graph) {
+	TaskPool pool {2};
+	JobGraph graph;
+
+	std::mutex mutex;
+	std::vector<std::string> order;
+
+	auto job = [&] (const std::string& name, int sleep) {
+		return [&, name, sleep] () {
+			std::this_thread::sleep_for(std::chrono::milliseconds(sleep));
+			std::lock_guard lock {mutex};
+			order.push_back(name);
+		};
+	};
+
+	graph.add("write", {}, {"x"}, job("write", 0));
+	graph.add("read", {"x"}, {"y"}, job("read", 20));
+	graph.add("main", {}, {"z"}, job("main", 0), true);
+	graph.add("join", {"y", "z"}, {}, job("join", 0));
+
+	graph.run(pool);
+
+	auto position = [&] (const std::string& name) {
+		return std::ranges::find(order, name) - order.begin();
+	};
+
+	CHECK(order.size(), 4);
+	ASSERT(position("write") < position("read"));
+	ASSERT(position("read") < position("join"));
+	ASSERT(position("main") < position("join"));
+
+	// the slow chain is the critical one
+	ASSERT(graph.getCriticalPath() == std::vector<std::string>({"write", "read", "join"}));
+	ASSERT(graph.getCriticalPathTime() >= 20);
+};
+
+TEST(util_message_bus) {
+	MessageBus bus;
+	std::atomic<int> alive = 0;
+
+	struct Large {
+		std::atomic<int>* alive;
+		char padding[128];
+
+		Large(std::atomic<int>* alive) : alive(alive) { (*alive) ++; }
+		Large(const Large& other) : alive(other.alive) { (*alive) ++; }
+		~Large() { (*alive) --; }
+	};
+
+	std::vector<std::thread> threads;
+
+	for (int t = 0; t < 4; t ++) {
+		threads.emplace_back([&bus, t] () {
+			for (int i = 0; i < 1000; i ++) {
+				bus.post(i % 2, t * 1000 + i);
+			}
+		});
+	}
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	bus.post(7, Large {&alive});
+	bus.post(7, std::string {"hello"});
+
+	std::map<uint64_t, int> counts;
+	std::map<int, int> last;
+	bool ordered = true;
+	int calls = 0;
+
+	size_t delivered = bus.deliver([&] (uint64_t receiver, std::span<Message* const> messages) {
+		calls ++;
+
+		for (const Message* message : messages) {
+			counts[receiver] ++;
+
+			if (message->is<int>()) {
+				const int value = message->as<int>();
+				const int thread = value / 1000;
+
+				// messages from one thread keep their order
+				ordered &= !last.contains(thread * 2 + receiver) || last[thread * 2 + receiver] < value;
+				last[thread * 2 + receiver] = value;
+			}
+
+			if (message->is<std::string>()) {
+				CHECK(message->as<std::string>(), "hello");
+			}
+		}
+	});
+
+	CHECK(delivered, 4002);
+	CHECK(calls, 3);
+	CHECK(counts[0], 2000);
+	CHECK(counts[1], 2000);
+	CHECK(counts[7], 2);
+	ASSERT(ordered);
+	CHECK(alive.load(), 0);
+
+	// everything was consumed
+	CHECK(bus.deliver([] (uint64_t, std::span<Message* const>) {}), 0);
+};
+
+TEST(util_task_pool_work_stealing) {
+	std::atomic<int> count = 0;
+
+	{
+		TaskPool pool {4};
+		PhasedTaskDelegator delegator {pool};
+
+		// tasks spawned by a worker land in its own deque, the idle workers have to steal them
+		delegator.enqueue([&] () {
+			ASSERT(pool.isWorker());
+
+			for (int i = 0; i < 1000; i ++) {
+				pool.enqueue([&] () {
+					count ++;
+				});
+			}
+		});
+
+		delegator.wait();
+		ASSERT(!pool.isWorker());
+		CHECK(pool.defer([] () { return 42; }).get(), 42);
+	}
+
+	// the pool finishes all the queued tasks before it's destroyed
+	CHECK(count.load(), 1000);
+};
+
+TEST(util_task_move_only) {
+	TaskPool pool {2};
+
+	// move-only captures work, and the result is carried by the future
+	auto value = std::make_unique<int>(42);
+
+	auto future = pool.defer([value = std::move(value)] () {
+		return *value;
+	});
+
+	CHECK(future.get(), 42);
+
+	int calls = 0;
+	Task inline_task = [&calls] () { calls ++; };
+
+	std::array<int, 64> large {};
+	large[0] = 2;
+
+	Task heap_task = [&calls, large] () { calls += large[0]; };
+
+	// moving leaves the source empty
+	Task moved = std::move(inline_task);
+	ASSERT(!inline_task);
+	moved();
+
+	heap_task = std::move(moved);
+	heap_task();
+	CHECK(calls, 2);
+
+	std::atomic<bool> ran = false;
+	pool.defer([&] () { ran = true; }).wait();
+	ASSERT(ran);
+
+	// exceptions are passed through the future
+	auto failed = pool.defer([] () -> int {
+		throw std::runtime_error {"failed"};
+	});
+
+	bool thrown = false;
+
+	try {
+		failed.get();
+	} catch (std::runtime_error& error) {
+		thrown = true;
+	}
+
+	ASSERT(thrown);
+};
+
+TEST(util_parallel_primitives) {
+	TaskPool pool {3};
+
+	std::vector<int> values(100000);
+	std::vector<std::atomic<int>> visits(values.size());
+
+	parallel::forEach(pool, 0, values.size(), [&] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i ++) {
+			values[i] = (int) ((i * 7919) % values.size());
+			visits[i] ++;
+		}
+	});
+
+	ASSERT(std::ranges::all_of(visits, [] (const std::atomic<int>& count) { return count == 1; }));
+
+	const long long sum = parallel::reduce(pool, 0, values.size(), 0LL, [&] (size_t begin, size_t end) {
+		return std::accumulate(values.begin() + begin, values.begin() + end, 0LL);
+	}, std::plus<> {}, 1000);
+
+	CHECK(sum, std::accumulate(values.begin(), values.end(), 0LL));
+
+	// chunks are combined in order, even with a non-commutative combine
+	const std::string text = parallel::reduce(pool, 0, 26, std::string {}, [] (size_t begin, size_t end) {
+		std::string part;
+
+		for (size_t i = begin; i < end; i ++) {
+			part += (char) ('a' + i);
+		}
+
+		return part;
+	}, std::plus<> {}, 3);
+
+	CHECK(text, std::string {"abcdefghijklmnopqrstuvwxyz"});
+
+	parallel::sort(pool, values.begin(), values.end());
+	ASSERT(std::ranges::is_sorted(values));
+
+	// nested calls from the workers complete, as the calling thread takes chunks itself
+	std::atomic<int> inner = 0;
+
+	parallel::forEach(pool, 0, 8, [&] (size_t begin, size_t end) {
+		parallel::forEach(pool, 0, 100, [&] (size_t first, size_t last) {
+			inner += (int) (last - first);
+		});
+	}, 1);
+
+	CHECK(inner.load(), 800);
+
+	bool thrown = false;
+
+	try {
+		parallel::forEach(pool, 0, 100, [] (size_t begin, size_t end) {
+			throw std::runtime_error {"failed"};
+		});
+	} catch (std::runtime_error& error) {
+		thrown = true;
+	}
+
+	ASSERT(thrown);
+};
+
+TEST(util_task_continuations) {
+
+	// a single worker would deadlock if any of the stages blocked waiting for another
+	TaskPool pool {1};
+
+	auto parse = tasks::spawn(pool, [] () {
+		return std::string {"1 2 3"};
+	});
+
+	auto decode = parse.then([] (const std::string& text) {
+		std::istringstream stream {text};
+		std::vector<int> values;
+
+		for (int value; stream >> value; ) {
+			values.push_back(value);
+		}
+
+		return values;
+	});
+
+	auto upload = decode.then([] (const std::vector<int>& values) {
+		return std::accumulate(values.begin(), values.end(), 0);
+	});
+
+	auto other = tasks::spawn(pool, [] () {
+		return 10;
+	});
+
+	std::atomic<int> joined = 0;
+
+	auto join = tasks::whenAll(pool, upload, other).then([&] () {
+		joined = upload.get() + other.get();
+	});
+
+	join.wait();
+	CHECK(joined.load(), 16);
+
+	auto first = tasks::whenAny(pool, tasks::spawn(pool, [] () {}), join);
+	ASSERT(first.get() < 2);
+
+	// failures skip the continuations and reach the final handle
+	std::atomic<bool> skipped = true;
+
+	auto failed = tasks::spawn(pool, [] () -> int {
+		throw std::runtime_error {"failed"};
+	}).then([&] (int value) {
+		skipped = false;
+		return value;
+	});
+
+	bool thrown = false;
+
+	try {
+		tasks::whenAll(pool, failed, other).get();
+	} catch (std::runtime_error& error) {
+		thrown = true;
+	}
+
+	ASSERT(thrown);
+	ASSERT(skipped);
+};
+
+TEST(util_coroutines) {
+	TaskPool pool {2};
+	TaskQueue queue;
+	AsyncEvent event;
+
+	const std::thread::id main = std::this_thread::get_id();
+	std::atomic<bool> on_worker = false;
+	std::atomic<bool> on_main = false;
+
+	// the queue plays the part of the main thread frame queue
+	auto load = [&] (int base) -> Async<int> {
+		co_await tasks::resumeOn(pool);
+		on_worker = pool.isWorker();
+
+		const int parsed = co_await tasks::spawn(pool, [base] () {
+			return base * 2;
+		});
+
+		co_await event;
+		co_await tasks::resumeOn(queue);
+		on_main = std::this_thread::get_id() == main;
+
+		co_return parsed + 1;
+	};
+
+	auto outer = [&] () -> Async<int> {
+		co_return co_await load(20) + 1;
+	};
+
+	Async<int> result = outer();
+	event.set();
+
+	while (!result.isDone()) {
+		queue.execute();
+		std::this_thread::yield();
+	}
+
+	CHECK(result.get(), 42);
+	ASSERT(on_worker);
+	ASSERT(on_main);
+
+	// futures are polled by the queue
+	std::promise<int> promise;
+	std::shared_future<int> future = promise.get_future().share();
+
+	auto waiter = [&] () -> Async<int> {
+		co_return co_await tasks::awaitFuture(future, queue);
+	};
+
+	Async<int> waited = waiter();
+	queue.execute();
+	ASSERT(!waited.isDone());
+
+	promise.set_value(7);
+	queue.execute();
+	CHECK(waited.get(), 7);
+
+	// exceptions reach the awaiting coroutine
+	auto failing = [] () -> Async<> {
+		throw std::runtime_error {"failed"};
+		co_return;
+	};
+
+	auto catching = [&] () -> Async<bool> {
+		try {
+			co_await failing();
+		} catch (std::runtime_error& error) {
+			co_return true;
+		}
+
+		co_return false;
+	};
+
+	ASSERT(catching().get());
+};
+
+TEST(util_task_pool_statistics) {
+	TaskPool pool {2};
+	PhasedTaskDelegator delegator {pool};
+
+	for (int i = 0; i < 100; i ++) {
+		delegator.enqueue([] () {
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		});
+	}
+
+	delegator.wait();
+
+	// the completion of the delegator runs inside the task, so the last record can still be in flight
+	for (int i = 0; i < 1000 && pool.getStatistics().getExecuted() < 100; i ++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	PoolStatistics statistics = pool.getStatistics();
+
+	CHECK(statistics.workers.size(), 2);
+	CHECK(statistics.getExecuted(), 100);
+	CHECK(statistics.execution.count, 100);
+	ASSERT(statistics.execution.percentile(0.5) >= 100'000);
+	ASSERT(statistics.execution.percentile(0.5) <= statistics.execution.percentile(0.99));
+	ASSERT(statistics.getUtilization() > 0);
+
+	const std::string json = statistics.toJson();
+	ASSERT(json.front() == '{' && json.back() == '}');
+	ASSERT(json.find("\"execution_ns\":{\"count\":100") != std::string::npos);
+
+	pool.resetStatistics();
+	CHECK(pool.getStatistics().getExecuted(), 0);
+};
+
+TEST(util_task_pool_priorities) {
+	TaskPool pool {1, 1};
+
+	std::mutex mutex;
+	std::vector<std::string> order;
+	std::promise<void> gate;
+	std::shared_future<void> opened = gate.get_future().share();
+
+	auto record = [&] (const std::string& name) {
+		return [&, name] () {
+			std::lock_guard lock {mutex};
+			order.push_back(name);
+		};
+	};
+
+	// occupy the only worker, so that the queued tasks have to wait
+	pool.enqueue([opened] () {
+		opened.wait();
+	}, TaskPriority::CRITICAL);
+
+	pool.enqueue(record("normal"));
+	pool.enqueue(record("critical"), TaskPriority::CRITICAL);
+
+	// the I/O lane runs background work even while the worker is busy
+	pool.defer([&] () {
+		record("background")();
+	}, TaskPriority::BACKGROUND).wait();
+
+	gate.set_value();
+	pool.defer([] () {}, TaskPriority::NORMAL).wait();
+
+	ASSERT(order == std::vector<std::string>({"background", "critical", "normal"}));
+
+	// work enqueued from the I/O lane is taken by the workers
+	std::thread::id lane;
+	bool lane_is_worker = false;
+
+	const std::thread::id worker = pool.defer([&] () {
+		lane = std::this_thread::get_id();
+		lane_is_worker = pool.isWorker();
+
+		return pool.defer([] () {
+			return std::this_thread::get_id();
+		}).get();
+	}, TaskPriority::BACKGROUND).get();
+
+	ASSERT(lane_is_worker);
+	ASSERT(worker != lane);
+
+	// and still runs when the lane enqueues it after the workers stopped
+	std::atomic<bool> finished = false;
+
+	{
+		TaskPool stopping {1, 1};
+
+		stopping.enqueue([&] () {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+			stopping.enqueue([&] () {
+				finished = true;
+			});
+		}, TaskPriority::BACKGROUND);
+	}
+
+	ASSERT(finished);
+};
+
+TEST(util_frame_arena) {
+	FrameArena arena {"test arena", 1024};
+
+	auto stats = [&] () {
+		for (const ArenaStatistics& statistics : FrameArena::getAllStatistics()) {
+			if (statistics.name == "test arena") return statistics;
+		}
+
+		return ArenaStatistics {};
+	};
+
+	auto frame = [&] () {
+		std::pmr::vector<int> values {&arena};
+
+		for (int i = 0; i < 1000; i ++) {
+			values.push_back(i);
+		}
+
+		CHECK(values[999], 999);
+		ASSERT(arena.getUsed() >= 1000 * sizeof(int));
+	};
+
+	CHECK(stats().capacity, 1024);
+	CHECK(stats().allocations, 1);
+
+	// the most recent allocation is given back
+	void* first = arena.allocate(100, 8);
+	arena.deallocate(first, 100, 8);
+	CHECK(arena.getUsed(), 0);
+
+	arena.allocate(1, 1);
+	void* aligned = arena.allocate(8, 64);
+	CHECK(reinterpret_cast<uintptr_t>(aligned) % 64, 0);
+
+	const size_t used = arena.getUsed();
+
+	{
+		FrameArena::Scope scope {arena};
+		arena.allocate(200, 8);
+		CHECK(arena.getUsed(), used + 200);
+	}
+
+	CHECK(arena.getUsed(), used);
+
+	// the first frame needs more than one chunk, they are merged by the reset
+	frame();
+	arena.reset();
+
+	const size_t allocations = stats().allocations;
+	CHECK(arena.getUsed(), 0);
+	CHECK(stats().frames, 1);
+	ASSERT(stats().last >= 1000 * sizeof(int));
+	ASSERT(stats().peak >= stats().last);
+
+	// steady state frames reuse the memory
+	for (int i = 0; i < 10; i ++) {
+		frame();
+		arena.reset();
+	}
+
+	CHECK(stats().allocations, allocations);
+	CHECK(stats().frames, 11);
+
+	CHECK(&FrameArena::current(), &FrameArena::current());
+};
+
 TEST(util_program_args) {
 	const char *argv[] = {
 		"program.exe", "--verbose", "--test", "value", "--another", "-f", "X", "-r", "-w"
@@ -695,6 +1318,30 @@ TEST(get_multiple_by_name) {
 	CHECK(board->findPawnByName("SetB")->getName(), "SetB");
 }
 
+TEST(search_by_atom) {
+	BOARD_SETUP
+
+	const Atom enemy = Atom::of("enemy");
+	ASSERT(Atom::of("enemy") == enemy);
+	CHECK(enemy.str(), "enemy");
+
+	std::shared_ptr<Pawn> r1 = std::make_shared<Pawn>("enemy");
+	std::shared_ptr<Pawn> r2 = std::make_shared<Pawn>("friend");
+
+	board->addPawnToRoot(r1);
+	board->addPawnToRoot(r2);
+
+	CHECK(board->findPawnByName(enemy), r1);
+	CHECK(board->findPawnsByName(enemy).size(), 1);
+	ASSERT(r1->getNameAtom() == enemy);
+
+	// renaming moves the pawn to the new name
+	r2->setName(enemy);
+	CHECK(board->findPawnsByName(enemy).size(), 2);
+	CHECK(board->findPawnByName("friend"), nullptr);
+	CHECK(r2->getName(), "enemy");
+}
+
 TEST(get_multiple_by_id) {
 	BOARD_SETUP
 
@@ -754,6 +1401,964 @@ TEST(remove_pawn) {
 	ASSERT(!w3.expired());
 };
 
+TEST(parallel_pawn_update) {
+	BOARD_SETUP
+
+	struct Record {
+		std::atomic<int> count = 0;
+		std::mutex mutex;
+		std::set<std::thread::id> threads;
+	};
+
+	struct CountingPawn : Pawn {
+		Record& record;
+
+		CountingPawn(Record& record) : record(record) {}
+
+		void onUpdate(double delta) override {
+			record.count ++;
+
+			// give the pool workers time to wake up and take some of the subtrees
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+			std::lock_guard lock {record.mutex};
+			record.threads.insert(std::this_thread::get_id());
+		}
+	};
+
+	Record serial;
+	Record parallel;
+
+	for (int i = 0; i < 100; i++) {
+		std::shared_ptr<Pawn> p = std::make_shared<CountingPawn>(parallel);
+		p->addChild(std::make_shared<CountingPawn>(parallel));
+		p->setThreadSafe(true);
+		board->addPawnToRoot(p);
+	}
+
+	for (int i = 0; i < 10; i++) {
+		board->addPawnToRoot(std::make_shared<CountingPawn>(serial));
+	}
+
+	manager.updateCycle();
+
+	CHECK(serial.count.load(), 10);
+	CHECK(parallel.count.load(), 200);
+
+	// without parallel update everything runs on the updating thread
+	CHECK(parallel.threads.size(), 1);
+	ASSERT(parallel.threads.contains(std::this_thread::get_id()));
+
+	parallel.threads.clear();
+	board->setParallelUpdate(true);
+	manager.updateCycle();
+
+	CHECK(serial.count.load(), 20);
+	CHECK(parallel.count.load(), 400);
+
+	// pawns that aren't thread-safe never leave the updating thread, while some subtrees ran on the workers
+	CHECK(serial.threads.size(), 1);
+	ASSERT(serial.threads.contains(std::this_thread::get_id()));
+	ASSERT(std::ranges::any_of(parallel.threads, [] (std::thread::id id) { return id != std::this_thread::get_id(); }));
+};
+
+TEST(parallel_pawn_structural_changes) {
+	BOARD_SETUP
+
+	struct CountingComponent : Component {
+		std::atomic<int>& updates;
+
+		CountingComponent(Pawn* pawn, std::atomic<int>* updates) : Component(pawn), updates(*updates) {
+			ticking = TICK_UPDATE;
+		}
+
+		void onUpdate(Context c) override {
+			updates ++;
+		}
+
+		void onFixedUpdate(FixedContext c) override {}
+		InputResult onEvent(const InputEvent& event) override { return InputResult::PASS; }
+		void onConnected() override {}
+	};
+
+	// the bullet-hell case, every thread-safe pawn changes its own subtree while the others do the same
+	struct SpawningPawn : Pawn {
+		std::atomic<int>& updates;
+		bool spawned = false;
+
+		SpawningPawn(std::atomic<int>& updates) : updates(updates) {}
+
+		void onUpdate(double delta) override {
+			if (spawned) {
+				return;
+			}
+
+			spawned = true;
+
+			auto child = std::make_shared<Pawn>();
+			child->setName("parallel_spawned");
+			child->createComponent<CountingComponent>(&updates);
+			addChild(child);
+
+			createComponent<CountingComponent>(&updates);
+			setName("parallel_renamed");
+
+			for (const std::shared_ptr<Pawn>& doomed : getChildren()) {
+				if (doomed->getName() == "parallel_doomed") {
+					doomed->remove();
+				}
+			}
+		}
+	};
+
+	std::atomic<int> updates = 0;
+	board->setParallelUpdate(true);
+
+	for (int i = 0; i < 100; i++) {
+		auto pawn = std::make_shared<SpawningPawn>(updates);
+		pawn->addChild(std::make_shared<Pawn>("parallel_doomed"));
+		pawn->setThreadSafe(true);
+		board->addPawnToRoot(pawn);
+	}
+
+	CHECK(board->getTree().nameHitSize("parallel_doomed"), 100);
+	manager.updateCycle();
+
+	// the changes were applied after the parallel phase, the same as if they were made serially
+	CHECK(board->getTree().nameHitSize("parallel_spawned"), 100);
+	CHECK(board->getTree().nameHitSize("parallel_renamed"), 100);
+	CHECK(board->getTree().nameHitSize("parallel_doomed"), 0);
+
+	for (const std::shared_ptr<Pawn>& spawned : board->getTree().findAllByName("parallel_spawned")) {
+		ASSERT(board->getTree().getPawn(spawned->getHandle()) == spawned.get());
+		ASSERT(spawned->getComponents().front()->getHandle() != ComponentHandle {});
+	}
+
+	// the new components joined the parallel tick list, two per spawning pawn
+	updates = 0;
+	manager.updateCycle();
+	CHECK(updates.load(), 200);
+};
+
+TEST(component_tick_lists) {
+	BOARD_SETUP
+
+	struct CountingComponent : Component {
+		int updates = 0;
+
+		CountingComponent(Pawn* pawn) : Component(pawn) {}
+
+		void onUpdate(Context c) override {
+			updates ++;
+		}
+
+		void onFixedUpdate(FixedContext c) override {}
+		InputResult onEvent(const InputEvent& event) override { return InputResult::PASS; }
+		void onConnected() override {}
+	};
+
+	auto pawn = std::make_shared<Pawn>();
+	auto component = pawn->createComponent<CountingComponent>();
+	board->addPawnToRoot(pawn);
+
+	manager.updateCycle();
+	CHECK(component->updates, 1);
+
+	component->setTicking(Component::TICK_NONE);
+	manager.updateCycle();
+	CHECK(component->updates, 1);
+
+	component->setTicking(Component::TICK_ALL);
+	manager.updateCycle();
+	CHECK(component->updates, 2);
+};
+
+TEST(component_array_iteration) {
+	struct ArrayComponent : Component {
+		ComponentArray* array = nullptr;
+		ArrayComponent* victim = nullptr;
+		int updates = 0;
+
+		ArrayComponent(Pawn* pawn) : Component(pawn) {}
+
+		void onUpdate(Context c) override {
+			updates ++;
+
+			if (victim) {
+				array->remove(victim);
+			}
+		}
+
+		void onFixedUpdate(FixedContext c) override {}
+		InputResult onEvent(const InputEvent& event) override { return InputResult::PASS; }
+		void onConnected() override {}
+	};
+
+	auto pawn = std::make_shared<Pawn>();
+	ComponentArray array {ComponentSlot::UPDATE};
+	std::vector<std::shared_ptr<ArrayComponent>> components;
+
+	// the same loop as the tick lists of a PawnTree
+	auto update = [&] () {
+		array.beginIteration();
+
+		for (size_t i = 0; i < array.size(); i ++) {
+			if (auto* component = static_cast<ArrayComponent*>(array[i])) {
+				component->onUpdate(Context(0.1, pawn.get()));
+			}
+		}
+
+		array.endIteration();
+	};
+
+	for (int i = 0; i < 4; i ++) {
+		components.push_back(std::make_shared<ArrayComponent>(pawn.get()));
+		array.insert(components.back().get());
+	}
+
+	update();
+
+	for (auto& component : components) {
+		CHECK(component->updates, 1);
+	}
+
+	// the first component removes itself and the second removes the last one, which wasn't updated yet
+	components[0]->array = &array;
+	components[0]->victim = components[0].get();
+	components[1]->array = &array;
+	components[1]->victim = components[3].get();
+
+	update();
+
+	CHECK(components[0]->updates, 2);
+	CHECK(components[1]->updates, 2);
+	CHECK(components[2]->updates, 2);
+	CHECK(components[3]->updates, 1);
+	CHECK(array.size(), 2);
+
+	// the holes are gone and the positions are consistent again
+	components[1]->victim = nullptr;
+	array.remove(components[1].get());
+	CHECK(array.size(), 1);
+	CHECK(array[0], components[2].get());
+};
+
+TEST(board_tick_list_scheduling) {
+	BOARD_SETUP
+
+	struct TickingComponent : Component {
+		int updates = 0;
+
+		TickingComponent(Pawn* pawn) : Component(pawn) {
+			ticking = TICK_UPDATE;
+		}
+
+		void onUpdate(Context c) override {
+			updates ++;
+		}
+
+		void onFixedUpdate(FixedContext c) override {}
+		InputResult onEvent(const InputEvent& event) override { return InputResult::PASS; }
+		void onConnected() override {}
+	};
+
+	auto pawn = std::make_shared<Pawn>();
+	auto other = std::make_shared<Pawn>();
+	auto ticking = pawn->createComponent<TickingComponent>();
+	auto added = other->createComponent<TickingComponent>();
+	board->addPawnToRoot(pawn);
+	board->addPawnToRoot(other);
+
+	manager.updateCycle();
+	CHECK(ticking->updates, 1);
+	CHECK(added->updates, 1);
+
+	// components follow the scheduling of their pawn, both time-sliced pawns are due in the first frame, then one per frame
+	pawn->setUpdatePriority(UpdatePriority::LOW);
+	other->setUpdatePriority(UpdatePriority::LOW);
+	board->setUpdateScheduling(true);
+	board->getUpdateScheduler().setRoundRobinSlice(1);
+
+	for (int i = 0; i < 4; i ++) {
+		manager.updateCycle();
+	}
+
+	CHECK(ticking->updates + added->updates, 2 + 2 + 1 + 1 + 1);
+};
+
+TEST(spatial_pawn_transform_hierarchy) {
+	BOARD_SETUP
+
+	struct TransformComponent : Component {
+		int changes = 0;
+
+		TransformComponent(Pawn* pawn) : Component(pawn) {
+			ticking = TICK_NONE;
+		}
+
+		void onUpdate(Context c) override {}
+		void onFixedUpdate(FixedContext c) override {}
+		InputResult onEvent(const InputEvent& event) override { return InputResult::PASS; }
+		void onConnected() override {}
+
+		void onTransformChanged() override {
+			changes ++;
+		}
+	};
+
+	auto parent = std::make_shared<SpatialPawn>();
+	auto child = std::make_shared<SpatialPawn>();
+	auto component = child->createComponent<TransformComponent>();
+
+	parent->setPosition({1, 0, 0});
+	child->setPosition({0, 2, 0});
+	parent->addChild(child);
+	board->addPawnToRoot(parent);
+
+	manager.updateCycle();
+	ASSERT(child->getWorldPosition() == glm::vec3(1, 2, 0));
+	CHECK(component->changes, 1);
+
+	// nothing moved, nothing should be recomputed
+	manager.updateCycle();
+	CHECK(board->getTree().getChangedTransforms().size(), 0);
+	CHECK(component->changes, 1);
+
+	parent->setPosition({5, 0, 0});
+	manager.updateCycle();
+	ASSERT(child->getPosition() == glm::vec3(0, 2, 0));
+	ASSERT(child->getWorldPosition() == glm::vec3(5, 2, 0));
+	CHECK(component->changes, 2);
+};
+
+TEST(pawn_handles_and_mass_removal) {
+	BOARD_SETUP
+
+	auto parent = std::make_shared<Pawn>("parent");
+	board->addPawnToRoot(parent);
+
+	std::vector<PawnHandle> handles;
+
+	for (int i = 0; i < 1000; i ++) {
+		auto pawn = std::make_shared<Pawn>("projectile");
+		pawn->addChild(std::make_shared<Pawn>("trail"));
+		parent->addChild(pawn);
+		handles.push_back(pawn->getHandle());
+	}
+
+	CHECK(board->findPawnsByName("projectile").size(), 1000);
+	CHECK(board->getPawn(handles[10]), parent->getChildren()[10].get());
+
+	// remove every other pawn
+	for (int i = 0; i < 1000; i += 2) {
+		board->getPawn(handles[i])->remove();
+	}
+
+	manager.updateCycle();
+
+	CHECK(parent->getChildren().size(), 500);
+	CHECK(board->findPawnsByName("projectile").size(), 500);
+	CHECK(board->findPawnsByName("trail").size(), 500);
+	CHECK(board->getPawn(handles[10]), nullptr);
+	ASSERT(board->getPawn(handles[11]) != nullptr);
+
+	// every pawn still knows its place in the children list after swap-removes
+	for (size_t i = 0; i < parent->getChildren().size(); i ++) {
+		board->getPawn(parent->getChildren()[i]->getHandle())->remove();
+	}
+
+	manager.updateCycle();
+
+	CHECK(parent->getChildren().size(), 0);
+	ASSERT(board->findPawnsByName("projectile").empty());
+	ASSERT(board->findPawnsByName("trail").empty());
+	CHECK(board->findPawnByName("parent"), parent);
+};
+
+TEST(spatial_index_queries) {
+	BOARD_SETUP
+
+	std::vector<std::shared_ptr<SpatialPawn>> line;
+
+	for (int i = 0; i < 100; i ++) {
+		auto pawn = std::make_shared<SpatialPawn>();
+		pawn->setPosition({i * 2.0f, 500, 0});
+		board->addPawnToRoot(pawn);
+		line.push_back(pawn);
+	}
+
+	manager.updateCycle();
+
+	CHECK(board->findPawnsInRadius({0, 500, 0}, 5).size(), 3);
+	CHECK(board->findPawnsInBox({9, 499, -1}, {21, 501, 1}).size(), 6);
+
+	std::vector<SpatialPawn*> nearest = board->findNearestPawns({41, 500, 0}, 2);
+	CHECK(nearest.size(), 2);
+	ASSERT(nearest[0] == line[20].get() || nearest[0] == line[21].get());
+
+	// the index follows transform changes and removals
+	line[99]->setPosition({0, 500, 1});
+	line[0]->remove();
+	manager.updateCycle();
+
+	CHECK(board->findPawnsInRadius({0, 500, 0}, 5).size(), 3);
+	CHECK(board->findNearestPawns({0, 500, 0}, 1)[0], line[99].get());
+};
+
+TEST(update_scheduler_tiers) {
+	BOARD_SETUP
+
+	class CountingPawn : public SpatialPawn {
+	public:
+		int updates = 0;
+
+		void onUpdate(double delta) override {
+			updates ++;
+		}
+	};
+
+	std::vector<std::shared_ptr<CountingPawn>> distant;
+
+	for (int i = 0; i < 4; i ++) {
+		auto pawn = std::make_shared<CountingPawn>();
+		pawn->setPosition({1000.0f + i, 0, 0});
+		board->addPawnToRoot(pawn);
+		distant.push_back(pawn);
+	}
+
+	auto critical = std::make_shared<CountingPawn>();
+	critical->setPosition({1000, 0, 0});
+	critical->setUpdatePriority(UpdatePriority::CRITICAL);
+	board->addPawnToRoot(critical);
+
+	// let the transforms settle before the distance is known
+	manager.updateCycle();
+	board->setUpdateScheduling(true);
+	board->getUpdateScheduler().setRoundRobinSlice(1);
+
+	for (int i = 0; i < 9; i ++) {
+		manager.updateCycle();
+	}
+
+	// all distant pawns are due in the first two frames, then one of them per frame
+	int total = 0;
+
+	for (auto& pawn : distant) {
+		total += pawn->updates;
+	}
+
+	CHECK(total, 4 + 4 + 8);
+	CHECK(critical->updates, 10);
+};
+
+TEST(update_scheduler_budget) {
+	BOARD_SETUP
+
+	class SlowPawn : public Pawn {
+	public:
+		int updates = 0;
+
+		void onUpdate(double delta) override {
+			updates ++;
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+	};
+
+	std::vector<std::shared_ptr<SlowPawn>> pawns;
+
+	for (int i = 0; i < 20; i ++) {
+		auto pawn = std::make_shared<SlowPawn>();
+		pawn->setUpdatePriority(i % 2 == 0 ? UpdatePriority::NORMAL : UpdatePriority::LOW);
+		board->addPawnToRoot(pawn);
+		pawns.push_back(pawn);
+	}
+
+	// every frame needs about 4ms, so the board stays over the budget
+	board->setUpdateScheduling(true);
+	board->getUpdateScheduler().setBudget(0.5);
+
+	for (int i = 0; i < 6; i ++) {
+		manager.updateCycle();
+		ASSERT(board->getUpdateScheduler().getDeferredCount() > 0);
+	}
+
+	// the pawns at the end of the tree are still updated, at least every other frame
+	for (auto& pawn : pawns) {
+		ASSERT(pawn->updates >= 3);
+	}
+
+	// low priority pawns yield first
+	int normal = 0;
+	int low = 0;
+
+	for (auto& pawn : pawns) {
+		(pawn->getUpdatePriority() == UpdatePriority::LOW ? low : normal) += pawn->updates;
+	}
+
+	ASSERT(normal > low);
+};
+
+TEST(board_snapshot_round_trip) {
+	BOARD_SETUP
+
+	auto parent = std::make_shared<SpatialPawn>();
+	parent->setName("snapshot_parent");
+	parent->setPosition({1, 2, 3});
+	parent->setScale({2, 2, 2});
+	parent->setThreadSafe(true);
+
+	auto child = std::make_shared<SpatialPawn>();
+	child->setName("snapshot_child");
+	child->setPosition({0, 1, 0});
+	child->createComponent<MatrixAnimation>(MatrixAnimation::TRANSLATE);
+	parent->addChild(child);
+
+	auto plain = std::make_shared<Pawn>();
+	plain->setName("snapshot_plain");
+	plain->setUpdatePriority(UpdatePriority::LOW);
+
+	board->addPawnToRoot(parent);
+	board->addPawnToRoot(plain);
+
+	const std::vector<uint8_t> bytes = BoardSnapshot::serialize(*board);
+	ASSERT(BoardSnapshot::serialize(*board) == bytes);
+
+	auto loaded = std::make_shared<Board>();
+	CHECK(BoardSnapshot::deserialize(*loaded, bytes.data(), bytes.size()), true);
+
+	auto loaded_child = std::dynamic_pointer_cast<SpatialPawn>(loaded->findPawnByName("snapshot_child"));
+	ASSERT(loaded_child != nullptr);
+	ASSERT(loaded_child->getParent()->getName() == "snapshot_parent");
+	ASSERT(loaded_child->getPosition() == glm::vec3(0, 1, 0));
+	CHECK(loaded_child->getComponents().size(), 1);
+	CHECK(loaded->findPawnByName("snapshot_parent")->isThreadSafe(), true);
+	ASSERT(loaded->findPawnByName("snapshot_plain")->getUpdatePriority() == UpdatePriority::LOW);
+
+	// the loaded board gives back the same bytes
+	ASSERT(BoardSnapshot::serialize(*loaded) == bytes);
+
+	// the same through a memory mapped file
+	const std::string path = (std::filesystem::temp_directory_path() / "checklight_snapshot_test.bin").string();
+	CHECK(BoardSnapshot::save(*board, path), true);
+
+	auto mapped = std::make_shared<Board>();
+	CHECK(BoardSnapshot::load(*mapped, path), true);
+	ASSERT(BoardSnapshot::serialize(*mapped) == bytes);
+	std::filesystem::remove(path);
+
+	// truncated snapshots are rejected without touching the board
+	auto broken = std::make_shared<Board>();
+	CHECK(BoardSnapshot::deserialize(*broken, bytes.data(), bytes.size() / 2), false);
+	CHECK(broken->getTree().getRoot()->getChildren().size(), 0);
+};
+
+TEST(board_manager_background_preparation) {
+	BOARD_SETUP
+
+	std::thread::id built;
+	std::thread::id bound;
+	BackendBindings::Handle binding;
+
+	auto future = manager.prepareBoard([&] (Board& prepared) {
+		auto pawn = std::make_shared<SpatialPawn>();
+		pawn->setName("prepared_pawn");
+		prepared.addPawnToRoot(pawn);
+
+		// components queue their render and sound bindings like this, and keep the handle
+		built = std::this_thread::get_id();
+		binding = BackendBindings::bind([&] () {
+			bound = std::this_thread::get_id();
+		});
+	});
+
+	// the board is only handed over at a frame boundary
+	for (int i = 0; i < 1000 && manager.isPreparingBoard(); i ++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		manager.updateCycle();
+	}
+
+	ASSERT(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+
+	std::shared_ptr<Board> prepared = future.get();
+	ASSERT(prepared != board);
+	ASSERT(manager.getCurrentBoard().lock() == prepared);
+	ASSERT(prepared->findPawnByName("prepared_pawn") != nullptr);
+
+	// the builder ran on a worker, while the bindings waited for the hand-over on the main thread
+	ASSERT(built != std::this_thread::get_id());
+	ASSERT(bound == std::this_thread::get_id());
+};
+
+TEST(board_manager_deferred_render_binding) {
+	BOARD_SETUP
+
+	// queues the same kind of binding as RenderComponent, but without the render object that needs a renderer
+	struct DeferredRender : RenderComponent {
+		int& bindings;
+		bool bound_rendering = false;
+
+		DeferredRender(SpatialPawn* pawn, int* bindings) : RenderComponent(pawn, Models::CUBE), bindings(*bindings) {
+			binding = BackendBindings::bind([this] () {
+				this->bindings ++;
+				bound_rendering = rendering;
+			});
+		}
+	};
+
+	int bindings = 0;
+	std::shared_ptr<DeferredRender> component;
+
+	auto future = manager.prepareBoard([&] (Board& prepared) {
+		auto pawn = std::make_shared<SpatialPawn>();
+		component = pawn->createComponent<DeferredRender>(&bindings);
+		prepared.addPawnToRoot(pawn);
+
+		// a pawn dropped by the builder (like after a failed load) takes its pending binding with it
+		auto temporary = std::make_shared<SpatialPawn>();
+		temporary->createComponent<DeferredRender>(&bindings);
+	});
+
+	for (int i = 0; i < 1000 && manager.isPreparingBoard(); i ++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		manager.updateCycle();
+	}
+
+	ASSERT(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+	future.get();
+
+	// the component was connected before the binding ran, so it has to bind as visible
+	ASSERT(component != nullptr);
+	CHECK(bindings, 1);
+	CHECK(component->bound_rendering, true);
+};
+
+TEST(board_manager_streamed_board) {
+	BOARD_SETUP
+
+	auto pawn = std::make_shared<SpatialPawn>();
+	pawn->setName("streamed_pawn");
+	pawn->setPosition({1, 2, 3});
+	pawn->createComponent<MatrixAnimation>(MatrixAnimation::ROTATE);
+	board->addPawnToRoot(pawn);
+
+	const std::string path = (std::filesystem::temp_directory_path() / "checklight_stream_test.bin").string();
+	CHECK(BoardSnapshot::save(*board, path), true);
+
+	auto future = manager.streamBoard(path);
+
+	for (int i = 0; i < 1000 && manager.isPreparingBoard(); i ++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		manager.updateCycle();
+	}
+
+	std::filesystem::remove(path);
+	ASSERT(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+
+	auto streamed = std::dynamic_pointer_cast<SpatialPawn>(future.get()->findPawnByName("streamed_pawn"));
+	ASSERT(streamed != nullptr);
+	ASSERT(streamed->getPosition() == glm::vec3(1, 2, 3));
+	CHECK(streamed->getComponents().size(), 1);
+
+	// missing files fail the future instead of the frame
+	auto missing = manager.streamBoard(path);
+
+	for (int i = 0; i < 1000 && manager.isPreparingBoard(); i ++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		manager.updateCycle();
+	}
+
+	ASSERT(missing.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+
+	bool failed = false;
+
+	try {
+		missing.get();
+	} catch (std::runtime_error& error) {
+		failed = true;
+	}
+
+	ASSERT(failed);
+};
+
+TEST(prefab_bulk_instantiation) {
+	BOARD_SETUP
+
+	auto root = std::make_shared<SpatialPawn>();
+	root->setName("prefab_root");
+	root->setScale({2, 2, 2});
+
+	auto child = std::make_shared<SpatialPawn>();
+	child->setName("prefab_child");
+	child->setPosition({0, 1, 0});
+	child->createComponent<MatrixAnimation>(MatrixAnimation::ROTATE);
+	root->addChild(child);
+
+	Prefab prefab {*root};
+	CHECK(prefab.size(), 2);
+
+	std::vector<std::shared_ptr<Pawn>> copies = prefab.instantiate(*board, 100, [] (Pawn& pawn, size_t index) {
+		static_cast<SpatialPawn&>(pawn).setPosition({index * 3.0f, 0, 0});
+	});
+
+	CHECK(copies.size(), 100);
+	CHECK(board->findPawnsByName("prefab_root").size(), 100);
+	CHECK(board->findPawnsByName("prefab_child").size(), 100);
+
+	auto copy = std::static_pointer_cast<SpatialPawn>(copies[7]);
+	ASSERT(copy->getPosition() == glm::vec3(21, 0, 0));
+	ASSERT(copy->getScale() == glm::vec3(2, 2, 2));
+	CHECK(copy->getChildren().size(), 1);
+	CHECK(copy->getChildren()[0]->getComponents().size(), 1);
+
+	// the template itself is not a part of the board
+	CHECK(root->isMountedToBoard(), false);
+};
+
+TEST(headless_render_and_sound_components) {
+	Headless::setEnabled(true);
+	BOARD_SETUP
+
+	auto pawn = std::make_shared<SpatialPawn>();
+	auto render = pawn->createComponent<RenderComponent>(Models::CUBE);
+	auto sound = pawn->createComponent<SoundComponent>("assets/sounds/1.ogg");
+	board->addPawnToRoot(pawn);
+
+	CHECK(render->hasRenderObject(), false);
+	CHECK(Headless::hasRenderer(), false);
+
+	for (int i = 0; i < 3; i ++) {
+		pawn->setPosition({i * 1.0f, 0, 0});
+		manager.updateCycle();
+	}
+
+	ASSERT(pawn->getWorldPosition() == glm::vec3(2, 0, 0));
+
+	Headless::setEnabled(false);
+};
+
+TEST(board_message_bus) {
+	BOARD_SETUP
+
+	struct Damage {
+		int amount;
+	};
+
+	auto target = std::make_shared<Pawn>();
+	auto removed = std::make_shared<Pawn>();
+	board->addPawnToRoot(target);
+	board->addPawnToRoot(removed);
+
+	int total = 0;
+	int received = 0;
+	int stray = 0;
+
+	target->listen<Damage>([&] (const Damage& damage) {
+		total += damage.amount;
+		received ++;
+	});
+
+	removed->listen<Damage>([&] (const Damage& damage) {
+		stray ++;
+	});
+
+	const PawnHandle target_handle = target->getHandle();
+	const PawnHandle removed_handle = removed->getHandle();
+
+	// the handle expires with the pawn
+	removed->remove();
+	manager.updateCycle();
+
+	std::vector<std::thread> threads;
+
+	for (int t = 0; t < 4; t ++) {
+		threads.emplace_back([&board, target_handle, removed_handle] () {
+			for (int i = 0; i < 100; i ++) {
+				board->post(target_handle, Damage {1});
+				board->post(removed_handle, Damage {1});
+			}
+		});
+	}
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	manager.updateCycle();
+
+	CHECK(received, 400);
+	CHECK(total, 400);
+	CHECK(stray, 0);
+
+	// messages are only delivered at phase boundaries
+	board->post(target_handle, Damage {5});
+	CHECK(total, 400);
+
+	manager.updateCycle();
+	CHECK(total, 405);
+
+	// boards ticked in the background receive their messages too
+	std::shared_ptr<Pawn> distant = std::make_shared<Pawn>();
+	int distant_total = 0;
+
+	distant->listen<Damage>([&] (const Damage& damage) {
+		distant_total += damage.amount;
+	});
+
+	auto future = manager.prepareBoard([&] (Board& prepared) {
+		prepared.addPawnToRoot(distant);
+	}, {}, false);
+
+	for (int i = 0; i < 1000 && manager.isPreparingBoard(); i ++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		manager.updateCycle();
+	}
+
+	std::shared_ptr<Board> background = future.get();
+	ASSERT(manager.getCurrentBoard().lock() == board);
+
+	manager.setBackgroundUpdateInterval(1);
+	background->post(distant->getHandle(), Damage {7});
+	manager.updateCycle();
+	CHECK(distant_total, 7);
+};
+
+TEST(board_batched_animations) {
+	BOARD_SETUP
+
+	auto clip = std::make_shared<AnimationClip>(1.0f);
+	clip->addPositionKey(1.0f, {10, 0, 0});
+	clip->addPositionKey(0.0f, {0, 0, 0});
+	clip->addScaleKey(0.0f, {1, 1, 1});
+	clip->addScaleKey(0.5f, {3, 3, 3});
+
+	AnimationSystem& animations = board->getTree().getAnimations();
+	std::vector<std::shared_ptr<SpatialPawn>> pawns;
+
+	// one clip shared by all the animations
+	for (int i = 0; i < 100; i ++) {
+		auto pawn = std::make_shared<SpatialPawn>();
+		pawn->createComponent<MatrixAnimation>(clip);
+		board->addPawnToRoot(pawn);
+		pawns.push_back(pawn);
+	}
+
+	auto spinner = std::make_shared<SpatialPawn>();
+	auto spin = spinner->createComponent<MatrixAnimation>(MatrixAnimation::ROTATE);
+	board->addPawnToRoot(spinner);
+
+	auto mover = std::make_shared<SpatialPawn>();
+	mover->createComponent<MatrixAnimation>(MatrixAnimation::TRANSLATE);
+	board->addPawnToRoot(mover);
+
+	CHECK(animations.size(), 102);
+
+	animations.update(0.25f);
+
+	for (const std::shared_ptr<SpatialPawn>& pawn : pawns) {
+		ASSERT(glm::length(pawn->getPosition() - glm::vec3(2.5, 0, 0)) < 0.001f);
+		ASSERT(glm::length(pawn->getScale() - glm::vec3(2, 2, 2)) < 0.001f);
+	}
+
+	// a quarter turn is a key of the builtin clip, so it's exact
+	const glm::quat expected = glm::rotate(glm::identity<glm::quat>(), (float) (M_PI / 2), glm::vec3(1, 1, 1));
+	ASSERT(glm::length(spinner->getRotation() * glm::vec3(1, 0, 0) - expected * glm::vec3(1, 0, 0)) < 0.001f);
+
+	// the builtin translation moves towards +5 on each axis during the first half of the loop
+	ASSERT(glm::length(mover->getPosition() - glm::vec3(2.5, 2.5, 2.5)) < 0.001f);
+
+	// clips loop
+	animations.update(1.0f);
+	ASSERT(std::abs(spin->getTime() - 0.25f) < 0.001f);
+
+	// removed pawns leave the system
+	pawns.back()->remove();
+	manager.updateCycle();
+	CHECK(animations.size(), 101);
+
+	// the cycle may have run a fixed update
+	const float before = spin->getTime();
+	spin->setSpeed(2);
+	animations.update(0.25f);
+	ASSERT(std::abs(spin->getTime() - std::fmod(before + 0.5f, 1.0f)) < 0.001f);
+};
+
+TEST(pawn_typed_component_lookup) {
+	BOARD_SETUP
+
+	struct Health : Component {
+		int value = 100;
+
+		Health(Pawn* pawn) : Component(pawn) {}
+
+		void onUpdate(Context c) override {}
+		void onFixedUpdate(FixedContext c) override {}
+		InputResult onEvent(const InputEvent& event) override { return InputResult::PASS; }
+		void onConnected() override {}
+	};
+
+	struct Armor : Health {
+		Armor(Pawn* pawn) : Health(pawn) {}
+	};
+
+	auto both = std::make_shared<Pawn>();
+	auto armored = std::make_shared<Pawn>();
+	auto plain = std::make_shared<Pawn>();
+
+	board->addPawnToRoot(both);
+	board->addPawnToRoot(armored);
+	board->addPawnToRoot(plain);
+
+	auto armor = both->createComponent<Armor>();
+	auto health = both->createComponent<Health>();
+	auto second = both->createComponent<Health>();
+	armored->createComponent<Armor>();
+
+	// only the exact class matches, and the first component of a class is returned
+	ASSERT(both->getComponent<Health>() == health.get());
+	ASSERT(both->getComponent<Armor>() == armor.get());
+	ASSERT(armored->getComponent<Health>() == nullptr);
+	ASSERT(plain->getComponent<Health>() == nullptr);
+	CHECK(second->getTypeId(), health->getTypeId());
+
+	ASSERT((both->hasComponents<Health, Armor>()));
+	ASSERT((!armored->hasComponents<Health, Armor>()));
+	ASSERT(armored->hasComponents<Armor>());
+
+	CHECK(board->findPawnsWithComponents<Health>().size(), 1);
+	CHECK(board->findPawnsWithComponents<Armor>().size(), 2);
+	CHECK((board->findPawnsWithComponents<Health, Armor>().size()), 1);
+
+	armored->remove();
+	manager.updateCycle();
+
+	CHECK(board->findPawnsWithComponents<Armor>().size(), 1);
+};
+
+TEST(board_manager_frame_queue_coroutine) {
+	BOARD_SETUP
+
+	int frames = 0;
+
+	auto coroutine = [&] () -> Async<> {
+		co_await tasks::resumeOn(manager.getFrameQueue());
+		frames ++;
+
+		// resuming from the queue enqueues again, so this continues in the following frame
+		co_await tasks::resumeOn(manager.getFrameQueue());
+		frames ++;
+	};
+
+	Async<> task = coroutine();
+	CHECK(frames, 0);
+
+	manager.updateCycle();
+	CHECK(frames, 1);
+
+	manager.updateCycle();
+	CHECK(frames, 2);
+	ASSERT(task.isDone());
+};
+
 TEST() {
 	BOARD_SETUP
 };